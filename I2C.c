@@ -15,10 +15,21 @@
 #include <xc.h>
 #include <stdint.h>
 #include "I2C.h"
+#include "abs_clock.h"
+#include "bus_stats.h"
+#include "trace.h"
 
 #define I2C_READ    1
 #define I2C_WRITE   0
 
+// From a start to the next stop, a failed selection leaves the bus held
+static uint8_t in_transaction = 0;
+TRACE_SLOT(I2C);
+
+// Bus utilisation, the LCD is only driven from the main loop
+static bus_stats_t i2c_stats;
+static uint32_t transaction_start_us;
+
 #define I2C_LCD_BACKLIGHT   8
 #define I2C_LCD_ENABLE      4
 #define I2C_LCD_RW          2
@@ -71,6 +82,20 @@ void I2C_wait() {
     }
 }
 
+/**
+ * Check the status of the operation just finished, counting a failure.
+ * 
+ * @param expected TWSR status code of success
+ * @return true if the operation succeeded
+ */
+static int I2C_Status(uint8_t expected) {
+    if ((TWSR & 0xf8) == expected) {
+        return 1;
+    }
+    bus_stats_error(&i2c_stats);
+    return 0;
+}
+
 /**
  * Send an I2C start bit.
  * 
@@ -78,9 +103,15 @@ void I2C_wait() {
  */
 int I2C_Start() {
     // Send I2C Start flag
+    if (!in_transaction) {
+        in_transaction = 1;
+        i2c_stats.transactions++;
+        transaction_start_us = micros();
+        TRACE_OPEN(I2C);
+    }
     TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN);
     I2C_wait();
-    return ((TWSR & 0xf8) == 0x08);
+    return I2C_Status(0x08);
 }
 
 /**
@@ -94,8 +125,9 @@ int I2C_SLA(uint8_t addr, uint8_t rw) {
     // Send I2C slave address
     TWDR = (addr << 1) | (rw & 1);
     TWCR = _BV(TWINT) | _BV(TWEN);
+    i2c_stats.bytes++;
     I2C_wait();
-    return ((TWSR & 0xf8) == 0x18);
+    return I2C_Status(0x18);
 }
 
 /**
@@ -108,8 +140,9 @@ int I2C_Send(uint8_t data) {
     // Send I2C data byte
     TWDR = data;
     TWCR = _BV(TWINT) | _BV(TWEN);
+    i2c_stats.bytes++;
     I2C_wait();
-    return ((TWSR & 0xf8) == 0x28);
+    return I2C_Status(0x28);
 }
 
 /**
@@ -121,6 +154,11 @@ void I2C_Stop() {
     for (volatile long x = 0; x < 100; x++) {
         ;
     }
+    if (in_transaction) {
+        in_transaction = 0;
+        i2c_stats.busy_us += micros() - transaction_start_us;
+        TRACE_CLOSE(I2C);
+    }
 }
 
 /**
@@ -139,6 +177,24 @@ int I2C_CheckAddress(uint8_t addr) {
     return ret;
 }
 
+/**
+ * Turn the I2C counters since the last roll into per second figures
+ * 
+ * @param elapsed_ms time since the last roll
+ */
+void I2C_Stats_Roll(uint16_t elapsed_ms) {
+    bus_stats_roll(&i2c_stats, elapsed_ms);
+}
+
+/**
+ * Copy the I2C bus counters
+ * 
+ * @param out where to copy them
+ */
+void I2C_Stats(bus_stats_t *out) {
+    *out = i2c_stats;
+}
+
 /**
  * Send four bits of data to a PCF8574 controlled HD44780 LCD display
  * We need to toggle the E bit (bit 2) from high to low to transmit the data
@@ -157,13 +213,16 @@ int I2C_CheckAddress(uint8_t addr) {
 int I2C_PCF8574_LCD_Nibble(uint8_t data) {
     TWDR = data | I2C_LCD_ENABLE;
     TWCR = _BV(TWINT) | _BV(TWEN);
+    i2c_stats.bytes++;
     I2C_wait();
-    if ((TWSR & 0xf8) == 0x28) {
-        TWDR = data & (~I2C_LCD_ENABLE);
-        TWCR = _BV(TWINT) | _BV(TWEN);
-        I2C_wait();
+    if (!I2C_Status(0x28)) {
+        return 0;
     }
-    return ((TWSR & 0xf8) == 0x28);
+    TWDR = data & (~I2C_LCD_ENABLE);
+    TWCR = _BV(TWINT) | _BV(TWEN);
+    i2c_stats.bytes++;
+    I2C_wait();
+    return I2C_Status(0x28);
 }
 
 /**
@@ -206,7 +265,7 @@ void I2C_SendData(uint8_t addr, uint8_t *array, uint8_t len, uint8_t flags) {
  * Send the initialisation string for a HD44780 LCD controller connected in
  * 4 bit mode. Taken from the data sheet. Transmit 0x30 three times to ensure
  * it is in 8 bit mode, then 0x20 to switch to 4 bit mode.
- * We then turn on the blinking cursor, backlight and clear the display.
+ * We then turn the display and backlight on, with no cursor, and clear it.
  * 
  * @param addr address of the LCD display
  * @return -1 if the display doesn't respond to a selection
@@ -221,7 +280,7 @@ int8_t LCD_PCF8574_Setup(uint8_t addr) {
     I2C_PCF8574_LCD_Nibble(0x30);
     I2C_PCF8574_LCD_Nibble(0x30);
     I2C_PCF8574_LCD_Nibble(0x20);
-    I2C_PCF8574_LCD_Byte(0x0f, I2C_LCD_BACKLIGHT);   // display on, cursor on and blinking
+    I2C_PCF8574_LCD_Byte(0x0c, I2C_LCD_BACKLIGHT);   // display on, cursor off
     I2C_PCF8574_LCD_Byte(0x01, I2C_LCD_BACKLIGHT);   // clear and move home
     I2C_Stop();
     return 0;
@@ -235,6 +294,7 @@ int8_t LCD_PCF8574_Setup(uint8_t addr) {
  */
 int8_t LCD_clear(uint8_t addr) {
     if (!(I2C_Start() && I2C_SLA(addr, I2C_WRITE))) {
+        I2C_Stop();
         return -1;
     }
     I2C_PCF8574_LCD_Byte(0x01, I2C_LCD_BACKLIGHT);   // clear screen command
@@ -253,6 +313,7 @@ int8_t LCD_clear(uint8_t addr) {
  */
 int8_t LCD_Position(uint8_t addr, uint8_t posn) {
     if (!(I2C_Start() && I2C_SLA(addr, I2C_WRITE))) {
+        I2C_Stop();
         return -1;
     }
     I2C_PCF8574_LCD_Byte(0x80 | posn, I2C_LCD_BACKLIGHT);   // set DRAM address
@@ -270,8 +331,31 @@ int8_t LCD_Position(uint8_t addr, uint8_t posn) {
  */
 int8_t LCD_Write(uint8_t addr, char *str, uint8_t len) {
     if (!(I2C_Start() && I2C_SLA(addr, I2C_WRITE))) {
+        I2C_Stop();
+        return -1;
+    }
+    while (len--) {
+        I2C_PCF8574_LCD_Byte(*str++, I2C_LCD_BACKLIGHT | I2C_LCD_RS);
+    }
+    I2C_Stop();
+    return 0;
+}
+
+/**
+ * Write a string at a position on the LCD display, in one transaction
+ * 
+ * @param addr address of the LCD display
+ * @param posn location of the first character (0x00 top left, 0x40 second row left)
+ * @param str pointer to the characters to display
+ * @param len number of characters to display
+ * @return -1 if the display doesn't respond to a selection
+ */
+int8_t LCD_Write_At(uint8_t addr, uint8_t posn, const char *str, uint8_t len) {
+    if (!(I2C_Start() && I2C_SLA(addr, I2C_WRITE))) {
+        I2C_Stop();
         return -1;
     }
+    I2C_PCF8574_LCD_Byte(0x80 | posn, I2C_LCD_BACKLIGHT);   // set DRAM address
     while (len--) {
         I2C_PCF8574_LCD_Byte(*str++, I2C_LCD_BACKLIGHT | I2C_LCD_RS);
     }
@@ -288,6 +372,7 @@ int8_t LCD_Write(uint8_t addr, char *str, uint8_t len) {
  */
 int8_t LCD_Write_Chr(uint8_t addr, char chr) {
     if (!(I2C_Start() && I2C_SLA(addr, I2C_WRITE))) {
+        I2C_Stop();
         return -1;
     }
     I2C_PCF8574_LCD_Byte(chr, I2C_LCD_BACKLIGHT | I2C_LCD_RS);
@@ -8,6 +8,7 @@
 #define	I2C_H
 
 #include <xc.h> // include processor files - each processor file is guarded.  
+#include "bus_stats.h"
 
 void setup_I2C();
 
@@ -55,6 +56,20 @@ void I2C_Stop();
  */
 int I2C_CheckAddress(uint8_t addr);
 
+/**
+ * Turn the I2C counters since the last roll into per second figures
+ * 
+ * @param elapsed_ms time since the last roll
+ */
+void I2C_Stats_Roll(uint16_t elapsed_ms);
+
+/**
+ * Copy the I2C bus counters
+ * 
+ * @param out where to copy them
+ */
+void I2C_Stats(bus_stats_t *out);
+
 /**
  * Send four bits of data to a PCF8574 controlled HD44780 LCD display
  * We need to toggle the E bit (bit 2) from high to low to transmit the data
@@ -99,7 +114,7 @@ void I2C_SendData(uint8_t addr, uint8_t *array, uint8_t len, uint8_t flags);
  * Send the initialisation string for a HD44780 LCD controller connected in
  * 4 bit mode. Taken from the data sheet. Transmit 0x30 three times to ensure
  * it is in 8 bit mode, then 0x20 to switch to 4 bit mode.
- * We then turn on the blinking cursor, backlight and clear the display.
+ * We then turn the display and backlight on, with no cursor, and clear it.
  * 
  * @param addr address of the LCD display
  * @return -1 if the display doesn't respond to a selection
@@ -135,6 +150,17 @@ int8_t LCD_Position(uint8_t addr, uint8_t posn);
  */
 int8_t LCD_Write(uint8_t addr, char *str, uint8_t len);
 
+/**
+ * Write a string at a position on the LCD display, in one transaction
+ * 
+ * @param addr address of the LCD display
+ * @param posn location of the first character (0x00 top left, 0x40 second row left)
+ * @param str pointer to the characters to display
+ * @param len number of characters to display
+ * @return -1 if the display doesn't respond to a selection
+ */
+int8_t LCD_Write_At(uint8_t addr, uint8_t posn, const char *str, uint8_t len);
+
 /**
  * Write a character to the LCD display
  * 
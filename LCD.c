@@ -3,112 +3,375 @@
  * Author: Traffic Light Controller
  * 
  * LCD display functions for traffic light controller
+ *
+ * The views and the startup banner only fill lcd_want, a copy of the two
+ * display rows in RAM. lcd_flush() runs every main loop pass and writes
+ * the first run of cells that differ from what the display shows, at
+ * most LCD_FLUSH_CELLS of them in one I2C transaction, so no pass is
+ * held up by the 40 kHz bus for longer than a few milliseconds and the
+ * light frames keep being published on time.
  */
 
 #include <xc.h>
+#include <avr/pgmspace.h>
 #include <stdint.h>
+#include <string.h>
 #include "I2C.h"
 #include "LCD.h"
 #include "Sensors.h"
 #include "abs_clock.h"
 #include "sensor_manager.h"
+#include "intersection.h"
+#include "boot.h"
+#include "stack.h"
+#include "config.h"
+#include "profile.h"
+#include "SPI.h"
 
 // External variables
-extern sensor_state_t sensors;
 extern volatile uint32_t time_counter;
-extern enum STATE state;
-extern enum ON HAZARD;
-extern light PRWS, PRES, PRWT, RWS, DMS;
+
+// Label and direction of each approach, from the topology
+typedef struct {
+    char label[3];
+    char dir;
+} approach_lcd_t;
+
+#define APPROACH_LCD(name, label, dir, green, yellow, red, conflicts) {label, dir},
+static const approach_lcd_t approach_lcd[NUM_APPROACHES] PROGMEM = {
+    TOPOLOGY_APPROACHES(APPROACH_LCD)
+};
+#undef APPROACH_LCD
+
+// Approaches shown for each phase, indexed by enum STATE
+#define PHASE_LCD(name, lead, overlap, serves, calls, yields_to, priority, timing, flags, lcd1, lcd2) \
+    {lcd1, lcd2},
+static const uint8_t phase_lcd[NUM_STATES][2] PROGMEM = {
+    {NO_APPROACH, NO_APPROACH},
+    TOPOLOGY_PHASES(PHASE_LCD)
+};
+#undef PHASE_LCD
+
+// Message catalog text, then the table of it, indexed by enum LCD_MSG
+#define LCD_MESSAGE_TEXT(name, text) \
+    _Static_assert(sizeof(text) <= 17, #name " is longer than a display line"); \
+    static const char text_##name[] PROGMEM = text;
+LCD_MESSAGES(LCD_MESSAGE_TEXT)
+#undef LCD_MESSAGE_TEXT
+
+#define LCD_MESSAGE_PTR(name, text) text_##name,
+static const char *const lcd_messages[NUM_LCD_MSGS] PROGMEM = {
+    LCD_MESSAGES(LCD_MESSAGE_PTR)
+};
+#undef LCD_MESSAGE_PTR
         uint8_t LCD_ADDR = 0x27; // current time for main loop
 
+// Addresses the display may be strapped to, tried in order
+const uint8_t default_lcd_addrs[LCD_NUM_ADDRS] PROGMEM = {0x27, 0x3f, 0x20};
+
+// Bring-up steps, one per call of lcd_boot()
+enum LCD_BOOT {
+    LCD_POWER_UP,       // Waiting for the controller to power up
+    LCD_PROBE,          // Trying the next address
+    LCD_BANNER,         // Showing the startup message
+    LCD_READY,          // Normal status display
+    LCD_ABSENT          // Nothing answered, carry on without a display
+};
+
 static uint8_t lcd_initialized = 0;
+static enum LCD_BOOT lcd_step = LCD_POWER_UP;
+static uint8_t lcd_probe = 0;
+static uint32_t lcd_since = 0;
+static enum LCD_VIEW lcd_view = LCD_VIEW_STATUS;
+
+// Rows as they should be and as the display shows them
+static char lcd_want[LCD_ROWS][LCD_COLS];
+static char lcd_shown[LCD_ROWS][LCD_COLS];
+static uint8_t lcd_scan = 0;            // Cell the next flush looks at first
+
+// Set a row, padded with spaces, the flush writes it out
+static void lcd_set_line(uint8_t row, const char *line) {
+    uint8_t i = 0;
+
+    for (; i < LCD_COLS && line[i]; i++) {
+        lcd_want[row][i] = line[i];
+    }
+    for (; i < LCD_COLS; i++) {
+        lcd_want[row][i] = ' ';
+    }
+}
+
+// Set a row to a catalog message
+static void lcd_set_message(uint8_t row, enum LCD_MSG msg) {
+    char line[LCD_COLS + 1];
+
+    strncpy_P(line, lcd_message_P(msg), LCD_COLS);
+    line[LCD_COLS] = '\0';
+    lcd_set_line(row, line);
+}
+
+// Second line of the banner: time to the first frame, "Frame at NN.N ms"
+static void show_boot_time(void) {
+    char line[17];
+    uint32_t us = boot_time_us(BOOT_FIRST_FRAME);
+
+    strncpy_P(line, lcd_message_P(MSG_FRAME_TIME), 16);
+    line[16] = '\0';
+    if (boot_reached(BOOT_FIRST_FRAME) && us < 100000) {
+        uint16_t tenths = us / 100;
+        line[9] = '0' + tenths / 100;
+        line[10] = '0' + (tenths / 10) % 10;
+        line[12] = '0' + tenths % 10;
+    }
+    lcd_set_line(1, line);
+}
+
+// Bring the display up a step at a time, called from the main loop until
+// lcd_ready(). The lights are already running by the time this starts,
+// so each call only does one short I2C job and returns; the banner text
+// goes out through lcd_flush().
+void lcd_boot(uint32_t now) {
+    switch (lcd_step) {
+        case LCD_POWER_UP:
+            if (!lcd_since) {
+                lcd_since = now ? now : 1;
+            }
+            if ((now - lcd_since) >= LCD_POWER_UP_MS) {
+                lcd_step = LCD_PROBE;
+            }
+            break;
+
+        case LCD_PROBE:
+            LCD_ADDR = config_get()->lcd_addrs[lcd_probe];
+            if (LCD_ADDR == 0) {
+                lcd_step = LCD_ABSENT;
+            } else if (setup_LCD(LCD_ADDR) == 0) {
+                lcd_initialized = 1;
+                boot_mark(BOOT_LCD);
 
-// Initialize LCD
-void lcd_init(void) {
-    // Small delay for LCD power-up
-    for (volatile uint16_t i = 0; i < 10000; i++);
-        if (setup_LCD(LCD_ADDR) == -1) {
-        LCD_ADDR = 0x3f;
-        if (setup_LCD(LCD_ADDR) == -1) {
-            LCD_ADDR = 0x20;
-            if (setup_LCD(LCD_ADDR) == -1) {
-                while(1) {
-                    PORTB ^= 0x20;  // flash the led as we don't know.
-                }
+                // Display startup message, on the display cleared by setup
+                memset(lcd_shown, ' ', sizeof(lcd_shown));
+                lcd_set_message(0, MSG_TITLE);
+                show_boot_time();
+                lcd_since = now;
+                lcd_step = LCD_BANNER;
+            } else if (++lcd_probe >= LCD_NUM_ADDRS) {
+                lcd_step = LCD_ABSENT;
             }
+            break;
+
+        case LCD_BANNER:
+            // Every view sets both whole rows, so no clear is needed
+            if ((now - lcd_since) >= LCD_BANNER_MS) {
+                lcd_step = LCD_READY;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// TRUE once the display is showing status, or there is no display
+enum ON lcd_ready(void) {
+    return (lcd_step >= LCD_READY) ? TRUE : FALSE;
+}
+
+// Write the first run of changed cells, every main loop pass
+void lcd_flush(void) {
+    if (!lcd_initialized) {
+        return;
+    }
+    for (uint8_t n = 0; n < LCD_ROWS * LCD_COLS; n++) {
+        uint8_t cell = (lcd_scan + n) % (LCD_ROWS * LCD_COLS);
+        uint8_t row = cell / LCD_COLS;
+        uint8_t col = cell % LCD_COLS;
+
+        if (lcd_want[row][col] == lcd_shown[row][col]) {
+            continue;
         }
+
+        // Unchanged cells inside the run are just written again
+        uint8_t len = LCD_COLS - col;
+        if (len > LCD_FLUSH_CELLS) {
+            len = LCD_FLUSH_CELLS;
+        }
+        if (LCD_Write_At(LCD_ADDR, (row ? 0x40 : 0x00) + col, &lcd_want[row][col], len) == 0) {
+            memcpy(&lcd_shown[row][col], &lcd_want[row][col], len);
+        }
+        lcd_scan = (cell + len) % (LCD_ROWS * LCD_COLS);
+        return;
     }
-    if (setup_LCD(LCD_ADDR) == 0) {
-        lcd_initialized = 1;
-        LCD_clear(LCD_ADDR);
-        
-        // Display startup message
-        LCD_Position(LCD_ADDR, 0x00);
-        LCD_Write(LCD_ADDR, "Traffic Control", 15);
-        LCD_Position(LCD_ADDR, 0x40);
-        LCD_Write(LCD_ADDR, "Initializing...", 15);
+}
+
+// Catalog message text, for reading with the pgm_read/_P functions
+const char* lcd_message_P(enum LCD_MSG msg) {
+    if (msg >= NUM_LCD_MSGS) {
+        msg = MSG_TITLE;
     }
+    return (const char*)pgm_read_ptr(&lcd_messages[msg]);
 }
 
-// Clear LCD
-void lcd_clear(void) {
-    if (lcd_initialized) {
-        LCD_clear(LCD_ADDR);
+// Direction indicator: a phase's only lead approach, or the only one of
+// its leads that is green
+static char get_direction_char(intersection_t *x) {
+    uint8_t leads = pgm_read_byte(&phase_table[x->state].lead);
+    uint8_t count = 0;
+    uint8_t greens = 0;
+    char lead_dir = ' ';
+    char green_dir = ' ';
+    
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        if (leads & APPROACH_BIT(a)) {
+            char dir = pgm_read_byte(&approach_lcd[a].dir);
+            count++;
+            lead_dir = dir;
+            if (GET_COLOUR(x, a) == GREEN) {
+                greens++;
+                green_dir = dir;
+            }
+        }
+    }
+    if (count == 1) {
+        return lead_dir;
     }
+    return (greens == 1) ? green_dir : ' ';
 }
 
-// Set cursor position (row: 0-1, col: 0-15)
-void lcd_goto(uint8_t col, uint8_t row) {
-    if (lcd_initialized) {
-        uint8_t pos = (row == 0) ? col : (0x40 + col);
-        LCD_Position(LCD_ADDR, pos);
+// Select the view shown from the next update
+void lcd_set_view(enum LCD_VIEW view) {
+    if (view < NUM_LCD_VIEWS) {
+        lcd_view = view;
     }
 }
 
-// Write string to LCD
-void lcd_puts(const char* str) {
-    if (!lcd_initialized) return;
-    
-    uint8_t len = 0;
-    while (str[len] && len < 16) {
-        len++;
+enum LCD_VIEW lcd_get_view(void) {
+    return lcd_view;
+}
+
+// Fill width digits ending at column last, saturating
+static void put_digits(char *line, uint8_t last, uint8_t width, uint32_t value) {
+    uint32_t limit = 1;
+
+    for (uint8_t i = 0; i < width; i++) {
+        limit *= 10;
+    }
+    if (value >= limit) {
+        value = limit - 1;
+    }
+    for (uint8_t i = 0; i < width; i++) {
+        line[last - i] = '0' + value % 10;
+        value /= 10;
     }
-    LCD_Write(LCD_ADDR, (char*)str, len);
 }
 
-// Write single character
-void lcd_putc(char c) {
-    if (lcd_initialized) {
-        LCD_Write_Chr(LCD_ADDR, c);
+// Write a catalog line with a 4 digit number in columns 11-14
+static void show_number_line(enum LCD_MSG msg, uint8_t row, uint16_t value) {
+    char line[17];
+
+    strncpy_P(line, lcd_message_P(msg), 16);
+    line[16] = '\0';
+    put_digits(line, 14, 4, value);
+    lcd_set_line(row, line);
+}
+
+// Profile view, "label  av NNNNNu" / "NNNNNu - NNNNNu", times in us
+static void show_profile(void) {
+    static uint8_t region = 0;
+    static uint8_t updates = 0;
+    char line[17];
+    profile_t p;
+
+    if (++updates >= LCD_PROFILE_UPDATES) {
+        updates = 0;
+        region = (region + 1) % NUM_PROFILE_REGIONS;
     }
+    if (!profile_get(region, &p)) {
+        p.min = p.max = p.total = p.samples = 0;
+    }
+
+    strncpy_P(line, lcd_message_P(MSG_PROF_MEAN), 16);
+    line[16] = '\0';
+    const char *label = profile_label_P(region);
+    for (uint8_t i = 0; i < 6 && pgm_read_byte(&label[i]); i++) {
+        line[i] = pgm_read_byte(&label[i]);
+    }
+    put_digits(line, 14, 5, profile_mean(&p) / (PROFILE_CYCLES_PER_MS / 1000));
+    lcd_set_line(0, line);
+
+    strncpy_P(line, lcd_message_P(MSG_PROF_RANGE), 16);
+    line[16] = '\0';
+    put_digits(line, 4, 5, p.min / (PROFILE_CYCLES_PER_MS / 1000));
+    put_digits(line, 13, 5, p.max / (PROFILE_CYCLES_PER_MS / 1000));
+    lcd_set_line(1, line);
 }
 
-// Update LCD display with system status
+// Diagnostics view, "Stack peak NNNNB" / "RAM free   NNNNB"
+static void show_diagnostics(void) {
+    show_number_line(MSG_DIAG_STACK, 0, stack_peak());
+    show_number_line(MSG_DIAG_FREE, 1, stack_free());
+}
+
+// Write a bus line, utilisation in columns 4-6, errors in columns 13-15
+static void show_bus_line(enum LCD_MSG msg, uint8_t row, const bus_stats_t *b) {
+    char line[17];
+
+    strncpy_P(line, lcd_message_P(msg), 16);
+    line[16] = '\0';
+    put_digits(line, 6, 3, b->util_pct);
+    put_digits(line, 15, 3, b->errors_last);
+    lcd_set_line(row, line);
+}
+
+// Bus view, "I2C NNN% err NNN" / "SPI NNN% err NNN", the last second
+static void show_bus(void) {
+    bus_stats_t b;
+
+    I2C_Stats(&b);
+    show_bus_line(MSG_BUS_I2C, 0, &b);
+    SPI_Stats(&b);
+    show_bus_line(MSG_BUS_SPI, 1, &b);
+}
+
+// Update LCD display with system status, lcd_flush() writes it out
 void lcd_update_display(void) {
-    if (!lcd_initialized) return;
+    if (lcd_step != LCD_READY) return;
     
+    if (lcd_view == LCD_VIEW_DIAG) {
+        show_diagnostics();
+        return;
+    }
+    if (lcd_view == LCD_VIEW_PROFILE) {
+        show_profile();
+        return;
+    }
+    if (lcd_view == LCD_VIEW_BUS) {
+        show_bus();
+        return;
+    }
+    
+    // The display shows the first intersection
+    intersection_t *x = &intersections[0];
     char line1[17];
     char line2[17];
     
     // Build Line 1: Sensor states and time counter
-    // Format: "SSSSSS TTTTT"
-    for (uint8_t i = 0; i < 6; i++) {
-        if (i == 5) {  // S6 is hazard
-            line1[i] = HAZARD ? 'X' : '_';
+    // Format: "SSSSSH     TTTTT", one S per approach detector, then hazard
+    for (uint8_t i = 0; i <= NUM_APPROACHES; i++) {
+        if (i == NUM_APPROACHES) {
+            line1[i] = x->hazard ? 'X' : '_';
         } else {
             // Show X if triggered but not handled, _ if handled
-            if (sensors.triggered & (1<<i)) {
-                line1[i] = (sensors.handled & (1<<i)) ? '_' : 'X';
+            if (x->sensors.triggered & (1<<i)) {
+                line1[i] = (x->sensors.handled & (1<<i)) ? '_' : 'X';
             } else {
                 line1[i] = '_';
             }
         }
     }
-    line1[6] = ' ';
-    line1[7] = ' ';
-    line1[8] = ' ';
-    line1[9] = ' ';
-    line1[10] = ' ';
+    for (uint8_t i = NUM_APPROACHES + 1; i < 11; i++) {
+        line1[i] = ' ';
+    }
     
     // Add time counter (5 digits)
     uint32_t display_time = time_counter % 100000;
@@ -120,68 +383,30 @@ void lcd_update_display(void) {
     line1[16] = '\0';
     
     // Build Line 2: Phase and color info
-    // Format: "DPPPCLLLC"
-    char dir = ' ';
-    const char* phase1 = "   ";
-    const char* phase2 = "   ";
-    char col1 = ' ';
-    char col2 = ' ';
+    // Format: "DPPPCLLLC", the phase's display approaches from the topology
+    for (uint8_t i = 0; i < 9; i++) {
+        line2[i] = ' ';
+    }
+    line2[9] = '\0';
     
-    if (state == Hazard) {
-        phase1 = "HZD";
-        col1 = ' ';
+    if (x->state == Hazard) {
+        memcpy_P(&line2[1], lcd_message_P(MSG_HAZARD), 3);
     } else {
-        switch (state) {
-            case Default:
-                phase1 = "PRT";
-                col1 = get_color_char(PRWS.colour);
-                
-                // Direction indicator
-                if (PRWS.colour == GREEN && PRES.colour != GREEN) {
-                    dir = 'W';
-                } else if (PRES.colour == GREEN && PRWS.colour != GREEN) {
-                    dir = 'E';
-                }
-                break;
-                
-            case ParkRdWestTurn:
-                dir = 'W';
-                phase1 = "PRT";
-                phase2 = "PWT";
-                col1 = get_color_char(PRWS.colour);
-                col2 = get_color_char(PRWT.colour);
-                break;
-                
-            case RailwayStThrough:
-                phase1 = "RST";
-                col1 = get_color_char(RWS.colour);
-                break;
-                
-            case DamStThrough:
-                phase1 = "DST";
-                col1 = get_color_char(DMS.colour);
-                break;
+        for (uint8_t s = 0; s < 2; s++) {
+            uint8_t a = pgm_read_byte(&phase_lcd[x->state][s]);
+            if (a == NO_APPROACH) {
+                continue;
+            }
+            for (uint8_t k = 0; k < 3; k++) {
+                line2[1 + 4 * s + k] = pgm_read_byte(&approach_lcd[a].label[k]);
+            }
+            line2[4 + 4 * s] = get_color_char(GET_COLOUR(x, a));
         }
+        line2[0] = get_direction_char(x);
     }
     
-    // Format line 2
-    line2[0] = dir;
-    line2[1] = phase1[0];
-    line2[2] = phase1[1];
-    line2[3] = phase1[2];
-    line2[4] = col1;
-    line2[5] = phase2[0];
-    line2[6] = phase2[1];
-    line2[7] = phase2[2];
-    line2[8] = col2;
-    line2[9] = '\0';
-    
-    // Write to LCD
-    lcd_goto(0, 0);
-    lcd_puts(line1);
-    lcd_goto(0, 1);
-    lcd_puts(line2);
-    lcd_goto(17, 1);
+    lcd_set_line(0, line1);
+    lcd_set_line(1, line2);
 }
 
 // Helper function to get color character
@@ -11,13 +11,60 @@
 #include <stdint.h>
 #include "Sensors.h"
 
+// Display bring-up
+#define LCD_NUM_ADDRS   3       // Addresses probed, 0 ends the list early
+#define LCD_POWER_UP_MS 50      // Controller power-up time before it is probed
+#define LCD_BANNER_MS   2000    // Time the startup message is shown
+
+// Display size, and the most cells lcd_flush() writes in a main loop
+// pass: about 5 ms of I2C at 40 kHz, well inside a 20 ms light frame
+#define LCD_ROWS        2
+#define LCD_COLS        16
+#define LCD_FLUSH_CELLS 4
+
+// Updates each profiled region is shown for
+#define LCD_PROFILE_UPDATES 10
+
+// Message catalog, kept in program memory
+// X(name, text), text at most 16 characters
+#define LCD_MESSAGES(X) \
+    X(MSG_TITLE,        "Traffic Control") \
+    X(MSG_FRAME_TIME,   "Frame at --.- ms") \
+    X(MSG_HAZARD,       "HZD") \
+    X(MSG_DIAG_STACK,   "Stack peak     B") \
+    X(MSG_DIAG_FREE,    "RAM free       B") \
+    X(MSG_PROF_MEAN,    "       av      u") \
+    X(MSG_PROF_RANGE,   "     u -      u ") \
+    X(MSG_BUS_I2C,      "I2C    % err    ") \
+    X(MSG_BUS_SPI,      "SPI    % err    ")
+
+// What the display shows once it is up
+enum LCD_VIEW {
+    LCD_VIEW_STATUS,    // Sensors, phase and lights of the first intersection
+    LCD_VIEW_DIAG,      // Stack high-water mark and free RAM
+    LCD_VIEW_PROFILE,   // Execution times, a region at a time
+    LCD_VIEW_BUS,       // I2C and SPI utilisation and errors
+    NUM_LCD_VIEWS
+};
+
+#define LCD_MESSAGE_ENUM(name, text) name,
+enum LCD_MSG {
+    LCD_MESSAGES(LCD_MESSAGE_ENUM)
+    NUM_LCD_MSGS
+};
+#undef LCD_MESSAGE_ENUM
+
+// Default probe list for the configuration (config.c)
+extern const uint8_t default_lcd_addrs[LCD_NUM_ADDRS] PROGMEM;
+
 // Function prototypes
-void lcd_init(void);
-void lcd_clear(void);
-void lcd_goto(uint8_t col, uint8_t row);
-void lcd_puts(const char* str);
-void lcd_putc(char c);
+void lcd_boot(uint32_t now);
+enum ON lcd_ready(void);
+void lcd_flush(void);
+const char* lcd_message_P(enum LCD_MSG msg);
 void lcd_update_display(void);
+void lcd_set_view(enum LCD_VIEW view);
+enum LCD_VIEW lcd_get_view(void);
 char get_color_char(enum COLOUR color);
 
 #endif /* LCD_H */
\ No newline at end of file
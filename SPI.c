@@ -9,8 +9,34 @@
  */
 
 #include <xc.h>
+#include <avr/interrupt.h>
 #include <stdint.h>
 #include "SPI.h"
+#include "bus_stats.h"
+#include "trace.h"
+
+// Bus utilisation, updated with interrupts off as the frame ISR shares the bus
+static bus_stats_t spi_stats;
+
+// Busy time of a select. SCK is fosc/4, 4 MHz, so a byte takes 2us on
+// the wire. The rest (slave select, loading SPDR and polling SPIF between
+// bytes) is taken as a fixed cost per select, estimated from the code.
+#define SPI_BYTE_US         2
+#define SPI_SELECT_US       6
+#define SPI_COMMAND_BYTES   3   // Opcode, register, data
+
+/**
+ * Count a transaction of a number of bytes.
+ * The busy time is worked out from the byte count, not timed: Timer2 only
+ * counts in 8us steps, and it runs in step with the frame interrupt that
+ * does most of the transfers, so the steps don't even out.
+ * 
+ * @param bytes bytes clocked while the slave was selected
+ */
+static void SPI_Count(uint8_t bytes) {
+    spi_stats.transactions++;
+    spi_stats.busy_us += SPI_SELECT_US + (uint16_t)bytes * SPI_BYTE_US;
+}
 
 /**
  * Transfer a byte of data across the SPI bus.
@@ -24,6 +50,10 @@ uint8_t SPI_transfer(uint8_t data) {
     while ((SPSR & _BV(SPIF)) == 0) {
         ;   // wait until transfer completed
     }
+    spi_stats.bytes++;
+    if (SPSR & _BV(WCOL)) {
+        bus_stats_error(&spi_stats);    // cleared by the SPDR read
+    }
     return SPDR;
 }
 
@@ -34,12 +64,30 @@ uint8_t SPI_transfer(uint8_t data) {
  * @param data value to write to command register
  */
 void SPI_Send_Command(uint8_t reg, uint8_t data) {
+    SPI_Send_Command_Addr(0, reg, data);
+}
+
+/**
+ * Send a command/data byte pair to the MCP23S17 at a hardware address
+ * 
+ * @param addr hardware address (A2-A0) of the MCP23S17
+ * @param reg command register to which we will be writing.
+ * @param data value to write to command register
+ */
+void SPI_Send_Command_Addr(uint8_t addr, uint8_t reg, uint8_t data) {
+    // The frame interrupt also drives the bus, keep it out mid transfer
+    char cSREG = SREG;
+    cli();
+    TRACE_BEGIN(SPI);
     // Send a command + byte to SPI interface
     PORTB &= ~_BV(2);    // SS enabled (low))
-    SPI_transfer(0x40);  // Send command for SPI data transfer
+    SPI_transfer(0x40 | (addr << 1));  // Send command for SPI data transfer
     SPI_transfer(reg);   // MCP23S17 register address
     SPI_transfer(data);  // data to write to MCP23S17 register
     PORTB |= _BV(2);    // SS disabled (high)
+    SPI_Count(SPI_COMMAND_BYTES);
+    TRACE_END(SPI);
+    SREG = cSREG;
 }
 
 /**
@@ -49,18 +97,59 @@ void SPI_Send_Command(uint8_t reg, uint8_t data) {
  * @return value of the register we read
  */
 uint8_t SPI_Read_Command(uint8_t reg) {
+    return SPI_Read_Command_Addr(0, reg);
+}
+
+/**
+ * Read the value of a register on the MCP23S17 at a hardware address
+ * 
+ * @param addr hardware address (A2-A0) of the MCP23S17
+ * @param reg data register we wish to read
+ * @return value of the register we read
+ */
+uint8_t SPI_Read_Command_Addr(uint8_t addr, uint8_t reg) {
     uint8_t data;
     
-    // TODO: Read a command output from SPI interface
+    // The frame interrupt also drives the bus, keep it out mid transfer
+    char cSREG = SREG;
+    cli();
+    TRACE_BEGIN(SPI);
     // Send a command + byte to SPI interface
     PORTB &= ~_BV(2);    // SS enabled (low))
-    SPI_transfer(0x41);  // Send command for SPI data transfer
+    SPI_transfer(0x41 | (addr << 1));  // Send command for SPI data transfer
     SPI_transfer(reg);   // MCP23S17 register address
     data = SPI_transfer(0);  // data to write to MCP23S17 register
     PORTB |= _BV(2);    // SS disabled (high)
+    SPI_Count(SPI_COMMAND_BYTES);
+    TRACE_END(SPI);
+    SREG = cSREG;
     return data;
 }
 
+/**
+ * Turn the SPI counters since the last roll into per second figures
+ * 
+ * @param elapsed_ms time since the last roll
+ */
+void SPI_Stats_Roll(uint16_t elapsed_ms) {
+    char cSREG = SREG;
+    cli();
+    bus_stats_roll(&spi_stats, elapsed_ms);
+    SREG = cSREG;
+}
+
+/**
+ * Copy the SPI bus counters
+ * 
+ * @param out where to copy them
+ */
+void SPI_Stats(bus_stats_t *out) {
+    char cSREG = SREG;
+    cli();
+    *out = spi_stats;
+    SREG = cSREG;
+}
+
 /**
  * Set up the SPI bus.
  * We assume a 16MHz IOclk rate, and that Port B 
@@ -75,9 +164,9 @@ void setup_SPI() {
 /**
  * Set up the Port Expander.
  *
- * We will configure port A as all outputs
- * Port B 0-3 are outputs and 4-7 are inputs
- * Turn on pull-up resistors on Port B
+ * Configures SPI and turns on hardware addressing (HAEN) in every
+ * MCP23S17 on the bus: until HAEN is set they all answer address 0.
+ * Each expander is then set up with setup_PortExpander_Addr().
  */
 void setup_PortExpander() {
     // Setup SPI operations (See pp176-177 of the data sheet)
@@ -86,14 +175,26 @@ void setup_PortExpander() {
     //Now that the SPI interface is configured we need to send SPI commands to
     //configure the MCP23S17 port expander IC
     SPI_Send_Command(0x0A, 0x6A);   // register IOCON (port A data direction)
-    SPI_Send_Command(0x00, 0x11);   // register IODIRA (port A data direction)
-    SPI_Send_Command(0x01, 0x11);   // register IODIRB (port B data direction)
-//    SPI_Send_Command(0x06, 0x11);   // register DEFVALA (port A Interrupt enable)
-//    SPI_Send_Command(0x07, 0x11);   // register DEFVALB (port B Interrupt enable)
-    SPI_Send_Command(0x08, 0x00);   // register INTCONB (port A Interrupt enable)
-    SPI_Send_Command(0x09, 0x00);   // register INTCONB (port B Interrupt enable)
-    SPI_Send_Command(0x0C, 0x11); // register GPPUA (port A GPIO Pullups)
-    SPI_Send_Command(0x0D, 0x11); // register GPPUB (port B GPIO Pullups)
-    SPI_Send_Command(0x04, 0x11); // register GPINTENA (port A Interrupt enable)
-    SPI_Send_Command(0x05, 0x11); // register GPINTENB (port A Interrupt enable)
-}
\ No newline at end of file
+}
+
+/**
+ * Set up one Port Expander.
+ *
+ * We will configure port A as all outputs
+ * Port B 0-3 are outputs and 4-7 are inputs
+ * Turn on pull-up resistors on Port B
+ *
+ * @param addr hardware address (A2-A0) of the MCP23S17
+ */
+void setup_PortExpander_Addr(uint8_t addr) {
+    SPI_Send_Command_Addr(addr, 0x00, 0x11);   // register IODIRA (port A data direction)
+    SPI_Send_Command_Addr(addr, 0x01, 0x11);   // register IODIRB (port B data direction)
+//    SPI_Send_Command_Addr(addr, 0x06, 0x11);   // register DEFVALA (port A Interrupt enable)
+//    SPI_Send_Command_Addr(addr, 0x07, 0x11);   // register DEFVALB (port B Interrupt enable)
+    SPI_Send_Command_Addr(addr, 0x08, 0x00);   // register INTCONB (port A Interrupt enable)
+    SPI_Send_Command_Addr(addr, 0x09, 0x00);   // register INTCONB (port B Interrupt enable)
+    SPI_Send_Command_Addr(addr, 0x0C, 0x11); // register GPPUA (port A GPIO Pullups)
+    SPI_Send_Command_Addr(addr, 0x0D, 0x11); // register GPPUB (port B GPIO Pullups)
+    SPI_Send_Command_Addr(addr, 0x04, 0x11); // register GPINTENA (port A Interrupt enable)
+    SPI_Send_Command_Addr(addr, 0x05, 0x11); // register GPINTENB (port A Interrupt enable)
+}
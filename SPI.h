@@ -4,6 +4,8 @@
 #ifndef SPI_H
 #define SPI_H
 
+#include "bus_stats.h"
+
 /**
  * Transfer a byte of data across the SPI bus.
  * We return the byte of data returned (as SPI is synchronous)
@@ -28,6 +30,38 @@ void SPI_Send_Command(uint8_t reg, uint8_t data);
  */
 uint8_t SPI_Read_Command(uint8_t reg);
 
+/**
+ * Send a command/data byte pair to the MCP23S17 at a hardware address
+ * 
+ * @param addr hardware address (A2-A0) of the MCP23S17
+ * @param reg command register to which we will be writing.
+ * @param data value to write to command register
+ */
+void SPI_Send_Command_Addr(uint8_t addr, uint8_t reg, uint8_t data);
+
+/**
+ * Read the value of a register on the MCP23S17 at a hardware address
+ * 
+ * @param addr hardware address (A2-A0) of the MCP23S17
+ * @param reg data register we wish to read
+ * @return value of the register we read
+ */
+uint8_t SPI_Read_Command_Addr(uint8_t addr, uint8_t reg);
+
+/**
+ * Turn the SPI counters since the last roll into per second figures
+ * 
+ * @param elapsed_ms time since the last roll
+ */
+void SPI_Stats_Roll(uint16_t elapsed_ms);
+
+/**
+ * Copy the SPI bus counters
+ * 
+ * @param out where to copy them
+ */
+void SPI_Stats(bus_stats_t *out);
+
 /**
  * Set up the SPI bus.
  * We assume a 16MHz IOclk rate, and that Port B Pin 2 is the SS output
@@ -36,9 +70,17 @@ void setup_SPI();
 
 /**
  * Set up the Port Expander.
+ * Turns on hardware addressing in every MCP23S17 on the bus.
  */
 void setup_PortExpander();
 
+/**
+ * Set up the Port Expander at a hardware address.
+ * 
+ * @param addr hardware address (A2-A0) of the MCP23S17
+ */
+void setup_PortExpander_Addr(uint8_t addr);
+
 
 #ifdef	__cplusplus
 extern "C" {
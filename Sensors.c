@@ -7,342 +7,388 @@
 
 #include "Sensors.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include "intersection.h"
 #include "abs_clock.h"
+#include "adaptive.h"
+#include "tod.h"
 #include "sensor_manager.h"
- // Global state variables
-enum STATE state = Hazard;
-enum ON HAZARD = TRUE;
+#include "phase_select.h"
+#include "tsp.h"
+#include "trace.h"
+#include "eventlog.h"
 
-// Light structures
-light PRWS = {YELLOW, FALSE, TRUE};  // Park Road West Straight
-light PRES = {YELLOW, FALSE, TRUE};  // Park Road East Straight
-light PRWT = {YELLOW, FALSE, TRUE};  // Park Road West Turn
-light RWS = {YELLOW, FALSE, TRUE};   // Railway Street
-light DMS = {YELLOW, FALSE, TRUE};   // Dam Street
+// Timing configurations, indexed by enum TIMING, copied into each intersection
+#define TIMING_ROW(name, min, max, passage, min_lo, min_hi, max_lo, max_hi) \
+    {0, 0, 0, 0, min, max, passage, 0, 0, 0},
+const phase_timing_t default_timing[NUM_TIMINGS] PROGMEM = {
+    TOPOLOGY_TIMINGS(TIMING_ROW)
+};
+#undef TIMING_ROW
 
+// Output bits for each colour of each approach, indexed [approach][enum COLOUR]
+#define COLOUR_ROW(name, label, dir, green, yellow, red, conflicts) \
+    {0, OUTPUT_BIT(red), OUTPUT_BIT(yellow), OUTPUT_BIT(green)},
+static const uint32_t colour_bits[NUM_APPROACHES][4] PROGMEM = {
+    TOPOLOGY_APPROACHES(COLOUR_ROW)
+};
+#undef COLOUR_ROW
 
+// Movement compatibility, indexed by approach: the approaches each one may
+// never show green or yellow alongside
+#define CONFLICT_ROW(name, label, dir, green, yellow, red, conflicts) conflicts,
+const uint8_t movement_conflicts[NUM_APPROACHES] PROGMEM = {
+    TOPOLOGY_APPROACHES(CONFLICT_ROW)
+};
+#undef CONFLICT_ROW
 
-// Timing configurations
-phase_timing_t timing_prws = {0, 0, 0, 4, 6, 0};  // Park Road West/East
-phase_timing_t timing_prwt = {0, 0, 0, 2, 4, 0};  // Park Road Turn
-phase_timing_t timing_rws = {0, 0, 0, 2, 3, 0};   // Railway Street
-phase_timing_t timing_dms = {0, 0, 0, 2, 4, 0};   // Dam Street
+// Phase definitions, indexed by enum STATE
+#define PHASE_ROW(name, lead, overlap, serves, calls, yields_to, priority, timing, flags, lcd1, lcd2) \
+    {lead, overlap, serves, calls, yields_to, priority, timing, flags},
+const phase_def_t phase_table[NUM_STATES] PROGMEM = {
+    // Hazard: lights are driven by the flash, not by a phase
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    TOPOLOGY_PHASES(PHASE_ROW)
+};
+#undef PHASE_ROW
 
-// Hazard timing
-uint32_t hazard_toggle_time = 0;
+// Approach bits are held in uint8_t, colours in a uint16_t
+_Static_assert(NUM_APPROACHES <= 8, "too many approaches for the approach bit masks");
+_Static_assert(NUM_SENSORS <= 8, "too many sensors for the sensor bit masks");
 
 // Get the combined light states for output
-uint32_t get_Lights(void) {
+uint32_t get_Lights(intersection_t *x) {
     uint32_t lights = 0;
-    uint16_t lights_low = 0;
-    uint16_t lights_high = 0;
+    uint16_t colours = x->light_colours;
     
-    // Dam Street lights (GPIOA)
-    switch (DMS.colour) {
-        case RED:    lights_low |= DSR; break;
-        case YELLOW: lights_low |= DSY; break;
-        case GREEN:  lights_low |= DSG; break;
-        default:     break;
+    // Hazard overrides the phase lights, so entry shows on the next frame
+    // even if the state machine hasn't run yet
+    if (x->hazard) {
+        colours = x->hazard_flash ? COLOUR_ALL(YELLOW) : COLOUR_ALL(OFF);
     }
     
-    // Park Road West lights (GPIOA)
-    switch (PRWS.colour) {
-        case RED:    lights_low |= PRWR; break;
-        case YELLOW: lights_low |= PRWY; break;
-        case GREEN:  lights_low |= PRWG; break;
-        default:     break;
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        lights |= pgm_read_dword(&colour_bits[i][colours & COLOUR_MASK]);
+        colours >>= COLOUR_BITS;
     }
-    
-    // Park Road Turn lights (GPIOB)
-    switch (PRWT.colour) {
-        case RED:    lights_low |= PRTR; break;
-        case YELLOW: lights_low |= PRTY; break;
-        case GREEN:  lights_low |= PRTG; break;
-        default:     break;
+    return lights;
+}
+
+// Set the colour of one approach
+void set_colour(intersection_t *x, uint8_t approach, enum COLOUR colour) {
+    uint8_t shift = COLOUR_BITS * approach;
+    x->light_colours = (x->light_colours & ~(COLOUR_MASK << shift)) | ((uint16_t)colour << shift);
+}
+
+
+// Count an event without wrapping
+static void count_sat(uint16_t *count) {
+    if (*count < 0xFFFF) {
+        (*count)++;
+    }
+}
+
+// Check if the phase green has ended, called each tick while a lead light
+// is green. Every actuation on a lead detector restarts the passage timer;
+// the green gaps out when the passage time runs out with no new actuation,
+// and maxes out at max_periods regardless.
+// hold keeps the green on past a gap (transit priority)
+static enum ON green_ended(intersection_t *x, phase_timing_t *timing, uint8_t lead, uint32_t now, enum ON hold) {
+    if ((x->light_demand | x->light_actuated) & lead) {
+        timing->passage_start = now;
     }
+    x->light_actuated &= ~lead;
+    
+    // Track elapsed time periods
+    timing->current_periods = (now - timing->green_start) / x->period_ms;
     
-    // Park Road East lights (GPIOB)
-    switch (PRES.colour) {
-        case RED:    lights_low |= PRER; break;
-        case YELLOW: lights_low |= PREY; break;
-        case GREEN:  lights_low |= PREG; break;
-        default:     break;
+    // Check minimum time
+    if (timing->current_periods < timing->min_periods) {
+        return FALSE;  // Still in minimum time
+    }
+    // Check maximum time
+    if (timing->current_periods >= timing->max_periods) {
+        count_sat(&timing->max_outs);
+        return TRUE;
     }
     
-    // Railway Street lights (Port C - handled separately)
-    switch (RWS.colour) {
-        case RED:    lights_high |= RSR; break;
-        case YELLOW: lights_high |= RSY; break;
-        case GREEN:  lights_high |= RSG; break;
-        default:     break;
+    // Between min and max - extend while vehicles keep arriving
+    if ((now - timing->passage_start) < (timing->passage_periods * x->period_ms)) {
+        return FALSE;
     }
-    lights |= lights_high;
-    lights = lights << 16;
-    lights |= lights_low;
-    return lights;
+    if (hold) {
+        // Held green for a bus
+        tsp_extended(x);
+        return FALSE;
+    }
+    count_sat(&timing->gap_outs);
+    return TRUE;
 }
 
+// Run a yellow light through to red
+static void update_light_timing(intersection_t *x, uint8_t approach, phase_timing_t *timing, uint32_t now) {
+    if (GET_COLOUR(x, approach) == YELLOW &&
+        (now - timing->yellow_start) >= (2 * x->period_ms)) {
+        set_colour(x, approach, RED);
+        timing->red_start = now;
+    }
+}
 
-// Check if it's time to change light color
-static void update_light_timing(light *lt, phase_timing_t *timing, uint32_t now) {
-    switch (lt->colour) {
-        case GREEN:
-            // Track elapsed time periods
-            timing->current_periods = (now - timing->green_start) / time_period_ms;
-            
-            // Check minimum time
-            if (timing->current_periods < timing->min_periods) {
-                return;  // Still in minimum time
-            }
-            // Check maximum time
-            if (timing->current_periods >= timing->max_periods) {
-                lt->colour = YELLOW;
-                timing->yellow_start = now;
-                return;
-            }
+// Time left before a green would have maxed out
+static uint32_t green_remaining(intersection_t *x, phase_timing_t *timing, uint32_t now) {
+    uint32_t max_ms = timing->max_periods * x->period_ms;
+    uint32_t elapsed = now - timing->green_start;
+    return (elapsed < max_ms) ? (max_ms - elapsed) : 0;
+}
 
-            // Between min and max - check if we should yield
-            if (!lt->on) {
-                // No more demand for this light
-                lt->colour = YELLOW;
-                timing->yellow_start = now;
-            }
-            break;
-            
-        case YELLOW:
-            if ((now - timing->yellow_start) >= (2 * time_period_ms)) {
-                lt->colour = RED;
-                lt->phaseDone = TRUE;
-                timing->red_start = now;
-            }
-            break;
-            
-        case RED:
-            // RED state is maintained until state machine changes it
-            break;
-            
-        case OFF:
-            // OFF is only used in hazard mode
-            break;
+// Read a phase definition out of program memory
+void get_phase(enum STATE phase, phase_def_t *def) {
+    memcpy_P(def, &phase_table[phase], sizeof(phase_def_t));
+}
+
+// Timing block of a phase
+phase_timing_t* get_phase_timing(intersection_t *x, enum STATE phase) {
+    return &x->timing[pgm_read_byte(&phase_table[phase].timing)];
+}
+
+// Sensor bits currently waiting to be served
+static uint8_t pending_calls(intersection_t *x) {
+    uint8_t pending = 0;
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        if (sensor_needs_handling(x, i)) {
+            pending |= APPROACH_BIT(i);
+        }
+    }
+    return pending;
+}
+
+// Movements that can run green alongside a phase: its own lead and overlap,
+// then anything compatible with them that is already green or has a call
+static uint8_t phase_movements(intersection_t *x, enum STATE phase, uint8_t pending) {
+    phase_def_t def;
+    get_phase(phase, &def);
+    uint8_t green = def.lead | def.overlap;
+    uint8_t running = 0;
+    
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        if (GET_COLOUR(x, i) == GREEN) {
+            running |= APPROACH_BIT(i);
+        }
+    }
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        if (((running | pending) & APPROACH_BIT(i)) &&
+            !(pgm_read_byte(&movement_conflicts[i]) & green)) {
+            green |= APPROACH_BIT(i);
+        }
     }
+    return green;
 }
 
-// Determine next state based on sensor inputs
-static enum STATE get_next_state(void) {
-     //Don't change state while any light is yellow
-    if (PRWS.colour == YELLOW || PRES.colour == YELLOW || 
-        PRWT.colour == YELLOW || RWS.colour == YELLOW || 
-        DMS.colour == YELLOW) {
-        return state;
+// Choose the phase to follow the one whose green has just ended
+static enum STATE choose_next_phase(intersection_t *x, uint32_t now) {
+    // A waiting bus goes first
+    if (tsp_waiting(x) && x->state != TSP_PHASE) {
+        return TSP_PHASE;
     }
     
-    // Check if current phase is truly done (all red with 2 second delay)
-    uint8_t all_red = TRUE;
-    uint32_t now = millis();
+    // Otherwise the selection policy picks from the called phases
+    return select_next_phase(x, x->state, pending_calls(x), now);
+}
+
+// End the running green: pick the next phase and clear only the movements
+// that conflict with it, compatible movements stay green across the change
+static void end_phase(intersection_t *x, phase_timing_t *timing, uint32_t now) {
+    enum STATE next = choose_next_phase(x, now);
     
-    switch (state) {
-        case Default:
-            if (PRWS.colour != RED || PRES.colour != RED) {
-                all_red = FALSE;
-            } else if ((now - timing_prws.red_start) < (2 * time_period_ms)) {
-                all_red = FALSE;
-            }
-            break;
-            
-        case ParkRdWestTurn:
-            if (PRWT.colour != RED) {
-                all_red = FALSE;
-            } else if ((now - timing_prwt.red_start) < (2 * time_period_ms)) {
-                all_red = FALSE;
-            }
-            break;
-            
-        case RailwayStThrough:
-            if (RWS.colour != RED) {
-                all_red = FALSE;
-            } else if ((now - timing_rws.red_start) < (2 * time_period_ms)) {
-                all_red = FALSE;
-            }
-            break;
-            
-        case DamStThrough:
-            if (DMS.colour != RED) {
-                all_red = FALSE;
-            } else if ((now - timing_dms.red_start) < (2 * time_period_ms)) {
-                all_red = FALSE;
-            }
-            break;
+    if (next == x->state) {
+        // Nothing else wants the junction, carry on in this phase
+        timing->green_start = now;
+        timing->passage_start = now;
+        return;
     }
     
-    if (!all_red) {
-        return state;  // Not ready to transition
+    x->next_phase = next;
+    x->next_green = phase_movements(x, next, pending_calls(x));
+    x->clearing = 0;
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        if (GET_COLOUR(x, i) == GREEN && !(x->next_green & APPROACH_BIT(i))) {
+            set_colour(x, i, YELLOW);
+            x->clearing |= APPROACH_BIT(i);
+        }
     }
+    timing->yellow_start = now;
+    x->changing = TRUE;
+}
+
+// TRUE once every movement being cleared is red plus the all-red time
+static enum ON phase_cleared(intersection_t *x, phase_timing_t *timing, uint32_t now) {
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        if ((x->clearing & APPROACH_BIT(i)) && GET_COLOUR(x, i) != RED) {
+            return FALSE;
+        }
+    }
+    return (!x->clearing || (now - timing->red_start) >= (2 * x->period_ms)) ? TRUE : FALSE;
+}
+
+// Turn the chosen phase and its concurrent movements green
+static void start_phase(intersection_t *x, uint32_t now) {
+    enum STATE old_state = x->state;
+    uint8_t pending = pending_calls(x);
+    uint8_t extras = x->next_green & pending & ~pgm_read_byte(&phase_table[x->next_phase].serves);
+    
+    x->state = x->next_phase;
+    x->changing = FALSE;
+    TRACE_PULSE(STATE);
+    eventlog_add(EVENT_STATE, EVENT_ARG(x->id, x->state));
     
-    // Priority order: Current phase completion -> Dam Street -> Railway -> Turn -> Default
+    // A cycle starts with the rest phase, new plans and splits take effect here
+    if (pgm_read_byte(&phase_table[x->state].flags) & PHASE_REST) {
+        tod_cycle(x);
+        adaptive_cycle(x);
+    }
     
-    // If we're not in default and no other demands, go to default
-    if (state != Default && !sensor_needs_handling(dms) && !sensor_needs_handling(rws) && !sensor_needs_handling(prwt)) {
-        return Default;
+    // Mark sensors as handled for new phase, and any movement joining it
+    mark_phase_sensors_handled(x, x->state);
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        if (extras & APPROACH_BIT(i)) {
+            mark_sensor_handled(x, i);
+        }
     }
+    select_phase_served(x, x->state, x->next_green, now);
     
-    // Check demands in priority order
-    if (sensor_needs_handling(dms) && state != DamStThrough) {
-        return DamStThrough;
-    } else if (sensor_needs_handling(rws) && state != RailwayStThrough) {
-        return RailwayStThrough;
-    } else if (sensor_needs_handling(prwt) && state != ParkRdWestTurn) {
-        return ParkRdWestTurn;
-    } else if (state != Default) {
-        // No demands, return to default
-        return Default;
+    if (old_state == TSP_PHASE) {
+        tsp_phase_ended(x);
+    }
+    if (x->state == TSP_PHASE) {
+        uint32_t red_ms = (GET_COLOUR(x, TSP_APPROACH) == GREEN) ? 0 :
+                          now - get_phase_timing(x, TSP_PHASE)->red_start;
+        tsp_phase_green(x, red_ms);
     }
     
-    // Stay in current state
-    return state;
+    // Start new phase lights
+    phase_timing_t *timing = get_phase_timing(x, x->state);
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        if (x->next_green & APPROACH_BIT(i)) {
+            set_colour(x, i, GREEN);
+        }
+    }
+    timing->green_start = now;
+    timing->passage_start = now;
+    timing->current_periods = 0;
+    x->light_actuated &= ~x->next_green;
 }
 
+// Enter hazard mode, called from the INT1 edge or the conflict monitor
+void Hazard_Enter(intersection_t *x, uint32_t now) {
+    if (x->hazard) {
+        return;
+    }
+    x->hazard_flash = TRUE;
+    x->hazard_toggle_time = now;
+    x->hazard = TRUE;
+    eventlog_add(EVENT_HAZARD_ON, x->id);
+}
 
-
-
+// Leave hazard mode into the Default phase (interrupts off)
+void Hazard_Exit(intersection_t *x, uint32_t now) {
+    x->state = Default;
+    TRACE_PULSE(STATE);
+    eventlog_add(EVENT_HAZARD_OFF, x->id);
+    
+    // Clear all sensor states
+    clear_all_sensors(x);
+    
+    // Start from all red, Default turns green once the all-red time is up
+    x->light_colours = COLOUR_ALL(RED);
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        x->timing[t].red_start = now;
+    }
+    x->next_phase = Default;
+    x->next_green = phase_movements(x, Default, 0);
+    x->clearing = (1 << NUM_APPROACHES) - 1;
+    x->changing = TRUE;
+    
+    // Reset all demands
+    x->light_demand = 0;
+    select_reset(x);
+    tsp_reset(x);
+    
+    x->hazard = FALSE;
+}
 
 // Main state machine
-void State_Manager(void) {
+void State_Manager(intersection_t *x) {
     uint32_t now = millis();
     
-    if (HAZARD) {
-        state = Hazard;
+    if (x->hazard) {
+        x->state = Hazard;
+        x->changing = FALSE;
         
-        // Flash yellow lights every second
-        if ((now - hazard_toggle_time) >= 1000) {
-            if (PRWS.colour == YELLOW) {
-                PRWS.colour = OFF;
-                PRES.colour = OFF;
-                PRWT.colour = OFF;
-                RWS.colour = OFF;
-                DMS.colour = OFF;
-            } else {
-                PRWS.colour = YELLOW;
-                PRES.colour = YELLOW;
-                PRWT.colour = YELLOW;
-                RWS.colour = YELLOW;
-                DMS.colour = YELLOW;
-            }
-            hazard_toggle_time = now;
+        // Flash yellow lights every second. Hazard_Enter() sets the flash
+        // from the INT1 interrupt, so keep it out while this steps it.
+        char cSREG = SREG;
+        cli();
+        if ((now - x->hazard_toggle_time) >= 1000) {
+            x->hazard_flash = !x->hazard_flash;
+            x->hazard_toggle_time = now;
         }
+        x->light_colours = x->hazard_flash ? COLOUR_ALL(YELLOW) : COLOUR_ALL(OFF);
+        SREG = cSREG;
         return;
     }
     
     // Normal operation
-    enum STATE next_state = get_next_state();
-
-    // Handle state transitions
-    if (next_state != state) {
-        // Mark sensors as handled for new phase
-        
-        enum STATE old_state = state;
-        state = next_state;
-
-        mark_phase_sensors_handled(state);
-
-
-        
-        // Start new phase lights
-        switch (state) {
-            case Default:
-                PRWS.colour = GREEN;
-                PRES.colour = GREEN;
-                timing_prws.green_start = now;
-                timing_prws.current_periods = 0;
-                PRWS.phaseDone = FALSE;
-                PRES.phaseDone = FALSE;
-                break;
-                
-            case ParkRdWestTurn:
-                PRWT.colour = GREEN;
-                timing_prwt.green_start = now;
-                timing_prwt.current_periods = 0;
-                PRWT.phaseDone = FALSE;
-                
-                // Allow Park Road straight to continue if coming from Default
-                if (old_state == Default && PRWS.colour == GREEN) {
-                    // Keep PRWS green
-                } else {
-                    PRWS.colour = GREEN;
-                    PRWS.phaseDone = FALSE;
-                }
-                break;
-                
-            case RailwayStThrough:
-                RWS.colour = GREEN;
-                timing_rws.green_start = now;
-                timing_rws.current_periods = 0;
-                RWS.phaseDone = FALSE;
-                break;
-                
-            case DamStThrough:
-                DMS.colour = GREEN;
-                timing_dms.green_start = now;
-                timing_dms.current_periods = 0;
-                DMS.phaseDone = FALSE;
-                break;
+    phase_def_t phase;
+    get_phase(x->state, &phase);
+    phase_timing_t *timing = get_phase_timing(x, x->state);
+    
+    // Run clearing movements through yellow to red, then start the next phase
+    for (uint8_t i = 0; i < NUM_APPROACHES; i++) {
+        update_light_timing(x, i, timing, now);
+    }
+    if (x->changing) {
+        if (phase_cleared(x, timing, now)) {
+            start_phase(x, now);
         }
+        return;
     }
     
-    // Update light timings based on current state
-    switch (state) {
-        case Default:
-            // Unlimited time if no other demands
-            if (!sensor_needs_handling(prwt) && !sensor_needs_handling(rws) && !sensor_needs_handling(dms)) {
-                break;  
-            }             
-                update_light_timing(&PRWS, &timing_prws, now);
-                update_light_timing(&PRES, &timing_prws, now);
-                
-            // Check if we need to yield to higher priority
-            if ((sensor_needs_handling(rws) || sensor_needs_handling(dms)) && 
-                (now - timing_prws.green_start) >= (timing_prws.min_periods * time_period_ms)) {
-
-                if (PRWS.colour == GREEN ) {
-                    PRWS.colour = YELLOW;
-                    timing_prws.yellow_start = now;
-                }
-                if (PRES.colour == GREEN) {
-                    PRES.colour = YELLOW;
-                    timing_prws.yellow_start = now;
-                }
-            }
-            break;
-            
-        case ParkRdWestTurn:
-            update_light_timing(&PRWT, &timing_prwt, now);
-
-            // Only update PRWS timing if it's not GREEN (don't disturb it if it's already green)
-            if (PRWS.colour != GREEN) {
-                update_light_timing(&PRWS, &timing_prws, now);
-            }
-
-            // Yield to higher priority (Dam or Railway)
-            if ((sensor_needs_handling(rws) || sensor_needs_handling(dms)) && PRWT.colour == GREEN &&
-                    (now - timing_prwt.green_start) >= (timing_prwt.min_periods * time_period_ms)) {
-                PRWT.colour = YELLOW;
-                timing_prwt.yellow_start = now;
-            }
-            break;
-            
-        case RailwayStThrough:
-            update_light_timing(&RWS, &timing_rws, now);
-            
-            // Yield to Dam Street (highest priority)
-            if (sensor_needs_handling(dms) && RWS.colour == GREEN && 
-                (now - timing_rws.green_start) >= (timing_rws.min_periods * time_period_ms)) {
-                RWS.colour = YELLOW;
-                timing_rws.yellow_start = now;
+    // Transit priority: hold the bus phase green, or cut other greens short
+    enum ON bus_hold = (x->state == TSP_PHASE) ? tsp_hold(x, now) : FALSE;
+    enum ON bus_call = (x->state != TSP_PHASE) ? tsp_waiting(x) : FALSE;
+    uint8_t pending = pending_calls(x);
+    uint8_t overdue = select_overdue(x, now) & ~phase.serves;
+    
+    // Calls waiting for any other phase
+    uint8_t other_calls = 0;
+    for (uint8_t p = Default; p < NUM_STATES; p++) {
+        if (p != x->state) {
+            other_calls |= pgm_read_byte(&phase_table[p].calls);
+        }
+    }
+    
+    // Rest phase has unlimited time if no other demands
+    if ((phase.flags & PHASE_REST) && !(pending & other_calls) && !bus_call) {
+        return;
+    }
+    
+    // Lead lights share the phase min/max/passage timing
+    if (green_ended(x, timing, phase.lead, now, bus_hold)) {
+        end_phase(x, timing, now);
+        return;
+    }
+    
+    // Check if we need to yield to higher priority
+    // or to an approach that has waited too long
+    if (((pending & (phase.yields_to | overdue)) || bus_call) &&
+        (now - timing->green_start) >= (timing->min_periods * x->period_ms)) {
+        if (bus_hold) {
+            tsp_extended(x);
+        } else {
+            if (bus_call && !(pending & (phase.yields_to | overdue))) {
+                tsp_cut(x, green_remaining(x, timing, now));
             }
-            break;
-            
-        case DamStThrough:
-            update_light_timing(&DMS, &timing_dms, now);
-            // Dam Street has highest priority, no need to yield
-            break;
+            end_phase(x, timing, now);
+        }
     }
-}
\ No newline at end of file
+}
@@ -3,26 +3,44 @@
 #define SENSORS_H
 
 #include <stdint.h>
+#include <avr/pgmspace.h>
+#include "topology.h"
 
 // Define bool type for XC8
 #define bool uint8_t
 #define true 1
 #define false 0
 
-#define dms 0 
-#define prws 1
-#define prwt 2 
-#define pres 3 
-#define rws 4 
+// Approach numbers (dms, prws, ...), from the topology
+#define APPROACH_ID(name, label, dir, green, yellow, red, conflicts) name,
+enum APPROACH {
+    TOPOLOGY_APPROACHES(APPROACH_ID)
+    NUM_APPROACHES
+};
+#undef APPROACH_ID
+
+// Sensor numbers (SENSOR_dms, ... SENSOR_bus), approach detectors first
+#define SENSOR_ID(name, source, bit) SENSOR_##name,
+enum SENSOR {
+    TOPOLOGY_SENSORS(SENSOR_ID)
+    NUM_SENSORS
+};
+#undef SENSOR_ID
+
+// Approach (and sensor) number to bit mask
+#define APPROACH_BIT(a) (1 << (a))
+
+// Bit number in the output word to mask
+#define OUTPUT_BIT(n) (1UL << (n))
 
-// States for the traffic controller
+// States for the traffic controller, Hazard then the topology's phases
+#define PHASE_ID(name, lead, overlap, serves, calls, yields_to, priority, timing, flags, lcd1, lcd2) name,
 enum STATE {
     Hazard,
-    Default,        // Park Road Through
-    ParkRdWestTurn,
-    RailwayStThrough,
-    DamStThrough
+    TOPOLOGY_PHASES(PHASE_ID)
+    NUM_STATES
 };
+#undef PHASE_ID
 
 // Light colors
 enum COLOUR {
@@ -38,62 +56,70 @@ enum ON {
     TRUE = 1
 };
 
-// Light structure
-typedef struct {
-    enum COLOUR colour;
-    enum ON on;         // Sensor triggered
-    enum ON phaseDone;  // Phase completed
-} light;
+// Light colours are packed 2 bits per approach into light_colours,
+// approach 0 in the lowest bits (up to 8 approaches fit in 16 bits)
+#define COLOUR_BITS 2
+#define COLOUR_MASK 0x03
+#define GET_COLOUR(x, a) ((enum COLOUR)(((x)->light_colours >> (COLOUR_BITS * (a))) & COLOUR_MASK))
+#define COLOUR_ALL(c) ((uint16_t)((c) * (((1UL << (COLOUR_BITS * NUM_APPROACHES)) - 1) / COLOUR_MASK)))
 
 // Timing variables for each phase
 typedef struct {
     uint32_t red_start;
     uint32_t green_start;
     uint32_t yellow_start;
+    uint32_t passage_start;     // Last actuation on a lead detector
     uint8_t min_periods;
     uint8_t max_periods;
+    uint8_t passage_periods;    // Green extension per actuation
     uint8_t current_periods;
+    uint16_t gap_outs;          // Greens ended by the passage timer
+    uint16_t max_outs;          // Greens ended by max_periods
 } phase_timing_t;
 
+// Timing blocks, indexed by phase_def_t.timing
+#define TIMING_ID(name, min, max, passage, min_lo, min_hi, max_lo, max_hi) name,
+enum TIMING {
+    TOPOLOGY_TIMINGS(TIMING_ID)
+    NUM_TIMINGS
+};
+#undef TIMING_ID
+
+// Phase flags
+#define PHASE_REST  0x01    // Green is held while no other phase is called
+
+// Phase definition, one row per enum STATE in phase_table (program memory)
+typedef struct {
+    uint8_t lead;       // Approach bits driven green and timed by this phase
+    uint8_t overlap;    // Approach bits always run green with the lead
+    uint8_t serves;     // Sensor bits marked handled when the phase starts
+    uint8_t calls;      // Sensor bits that call this phase
+    uint8_t yields_to;  // Sensor bits that end the green once min_periods are up
+    uint8_t priority;   // Highest called phase is served next
+    uint8_t timing;     // enum TIMING block used by the phase
+    uint8_t flags;      // PHASE_ flags
+} phase_def_t;
+
+
+// Controller context of one intersection (intersection.h)
+typedef struct intersection intersection_t;
 
 // External variables
-extern enum STATE state;
-extern light PRWS, PRES, PRWT, RWS, DMS;
-extern phase_timing_t timing_prws, timing_prwt, timing_rws, timing_dms;
-extern enum ON HAZARD;
+extern const phase_timing_t default_timing[NUM_TIMINGS] PROGMEM;
+extern const phase_def_t phase_table[NUM_STATES] PROGMEM;
+extern const uint8_t movement_conflicts[NUM_APPROACHES] PROGMEM;
 extern volatile uint32_t time_period_ms;  // Time period in milliseconds
 
 // Function prototypes
 void Sensor_Manager(int sensor);
-void State_Manager(void);
+void State_Manager(intersection_t *x);
 void Colour_Manager(void);
-uint32_t get_Lights(void);
+uint32_t get_Lights(intersection_t *x);
+void set_colour(intersection_t *x, uint8_t approach, enum COLOUR colour);
 void setup_sensors(void);
-
-#define S0      0x01
-#define DSG     0x02
-#define DSY     0x04
-#define DSR     0x08
-
-#define S1      0x10
-#define PRWG    0x20
-#define PRWY    0x40
-#define PRWR    0x80
-
-#define S2      0x01
-#define PRTG    0x0200
-#define PRTY    0x0400
-#define PRTR    0x0800
-
-#define S3      0x10
-#define PREG    0x2000
-#define PREY    0x4000
-#define PRER    0x8000
-
-
-#define S4      0x01
-#define RSG     0x02
-#define RSY     0x04
-#define RSR     0x08
+void Hazard_Enter(intersection_t *x, uint32_t now);
+void Hazard_Exit(intersection_t *x, uint32_t now);
+void get_phase(enum STATE phase, phase_def_t *def);
+phase_timing_t* get_phase_timing(intersection_t *x, enum STATE phase);
 
 #endif // SENSORS_H
\ No newline at end of file
@@ -5,10 +5,13 @@
 #include "abs_clock.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include "trace.h"
 uint32_t   clock_count = 0;
 
 ISR(TIMER2_COMPA_vect) {
+    TRACE_BEGIN(CLOCK_ISR);
     clock_count++;
+    TRACE_END(CLOCK_ISR);
 }
 
 uint32_t millis() {
@@ -29,6 +32,27 @@ uint32_t millis() {
     return count;
 }
 
+uint32_t micros() {
+    /*
+     * Microseconds, to the 8us Timer2 count, wrapping every 71 minutes.
+     * If the compare match is pending (interrupts were off when it came)
+     * the count has wrapped but clock_count hasn't been incremented yet.
+     */
+    register uint32_t count;
+    register uint8_t ticks;
+    register char cSREG;
+
+    cSREG = SREG;
+    cli();
+    ticks = TCNT2;
+    count = clock_count;
+    if ((TIFR2 & _BV(OCF2A)) && ticks < 62) {
+        count++;
+    }
+    SREG = cSREG;
+    return count * 1000 + (uint16_t)ticks * 8;
+}
+
 void setupTimer2() {
     /*
      * Timer 2 is setup as a millisecond interrupting timer.
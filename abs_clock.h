@@ -7,6 +7,7 @@
 #include <xc.h> // include processor files - each processor file is guarded.  
 extern uint32_t   clock_count;
 uint32_t millis();
+uint32_t micros();
 void setupTimer2();
 void setupTimer1();
 #endif //ABS_CLOCK_H
@@ -0,0 +1,255 @@
+/*
+ * File:   adaptive.c
+ * Author: Traffic Light Controller
+ * 
+ * Online split optimiser.
+ *
+ * Once a minute the per-approach counts and green times from the stats
+ * module are folded into smoothed flows. Each timing block's critical flow
+ * ratio y is its busiest lead approach's flow times the saturation headway.
+ * Webster's formula then gives the cycle length
+ *
+ *     C = (1.5 L + 5 s) / (1 - Y)
+ *
+ * and each phase is given a share (C - L) * y / Y of the effective green.
+ * That green becomes the phase's max_periods, with min_periods at half of
+ * it, both clamped to the safe bounds below. The plan is only written into
+ * the intersection's timing at a cycle boundary (the rest phase turning
+ * green), so a phase never has its limits changed while it is running.
+ * While the optimiser is off the time of day plan (tod.c) sets the limits
+ * instead.
+ *
+ * Whether it runs comes from the configuration (config.c), and can be
+ * changed with the "A0" / "A1" host commands. "A" dumps each
+ * intersection's current plan, so its effect can be audited.
+ */
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "Sensors.h"
+#include "intersection.h"
+#include "stats.h"
+#include "config.h"
+#include "host.h"
+#include "adaptive.h"
+
+// Safe limits per timing block, in periods (topology.h)
+typedef struct {
+    uint8_t min_lo;
+    uint8_t min_hi;
+    uint8_t max_lo;
+    uint8_t max_hi;
+} adaptive_bounds_t;
+
+#define BOUNDS_ROW(name, min, max, passage, min_lo, min_hi, max_lo, max_hi) \
+    {min_lo, min_hi, max_lo, max_hi},
+static const adaptive_bounds_t bounds[NUM_TIMINGS] PROGMEM = {
+    TOPOLOGY_TIMINGS(BOUNDS_ROW)
+};
+#undef BOUNDS_ROW
+
+// Optimiser state of one intersection
+typedef struct {
+    enum ON on;
+    adaptive_plan_t plan;
+    uint16_t flow_q4[NUM_APPROACHES];   // Smoothed vehicles/minute, x4
+    uint16_t last_minute;               // Stats minute last folded in
+} adaptive_t;
+
+// Kept across a warm restart (restart.c)
+static adaptive_t adaptive[NUM_INTERSECTIONS] __attribute__((section(".noinit")));
+
+static const char dump_header[] PROGMEM = "id on/off cycle applied, then timing vpm y% used% min max\r\n";
+static const char dump_on[] PROGMEM = " on ";
+static const char dump_off[] PROGMEM = " off ";
+static const char dump_eol[] PROGMEM = "\r\n";
+
+static uint8_t clamp(uint16_t value, uint8_t lo, uint8_t hi) {
+    return (value < lo) ? lo : (value > hi) ? hi : value;
+}
+
+// Cold start: nothing measured yet, on or off as configured
+void adaptive_init(intersection_t *x) {
+    adaptive_t *ad = &adaptive[x->id];
+
+    ad->on = config_get()->adaptive_on ? TRUE : FALSE;
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        ad->plan.min_periods[t] = x->timing[t].min_periods;
+        ad->plan.max_periods[t] = x->timing[t].max_periods;
+        ad->plan.flow_vpm[t] = 0;
+        ad->plan.flow_ratio_pct[t] = 0;
+        ad->plan.green_used_pct[t] = 0;
+    }
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        ad->flow_q4[a] = 0;
+    }
+    ad->plan.cycle_periods = 0;
+    ad->plan.applied = 0;
+    ad->last_minute = stats_minutes(x);
+}
+
+void adaptive_enable(intersection_t *x, enum ON on) {
+    adaptive[x->id].on = on;
+}
+
+enum ON adaptive_enabled(intersection_t *x) {
+    return adaptive[x->id].on;
+}
+
+// State preserved across a warm restart
+const void *adaptive_preserved(uint16_t *len) {
+    *len = sizeof(adaptive);
+    return adaptive;
+}
+
+// Lead approaches of the phases using a timing block
+static uint8_t timing_leads(uint8_t t) {
+    uint8_t leads = 0;
+    for (uint8_t p = Default; p < NUM_STATES; p++) {
+        if (pgm_read_byte(&phase_table[p].timing) == t) {
+            leads |= pgm_read_byte(&phase_table[p].lead);
+        }
+    }
+    return leads;
+}
+
+// Fold the last complete minute into the flows and work out a new plan
+static void replan(intersection_t *x, adaptive_t *ad) {
+    uint8_t y_pct[NUM_TIMINGS];
+    uint16_t y_total = 0;
+    uint8_t phases = 0;
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        uint16_t count = stats_get(x, a, STATS_LAST_MINUTE)->count;
+        uint16_t q4 = (count > 0x3FFF) ? 0xFFFF : count * 4;
+        ad->flow_q4[a] = ad->flow_q4[a] - ad->flow_q4[a] / 4 + q4 / 4;
+    }
+
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        uint8_t leads = timing_leads(t);
+        uint16_t q4 = 0;
+        uint16_t green_ds = 0;
+        if (!leads) {
+            y_pct[t] = 0;
+            continue;
+        }
+        phases++;
+
+        for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+            if (leads & APPROACH_BIT(a)) {
+                const stats_bin_t *bin = stats_get(x, a, STATS_LAST_MINUTE);
+                if (ad->flow_q4[a] > q4) {
+                    q4 = ad->flow_q4[a];
+                }
+                if (bin->green_ds > green_ds) {
+                    green_ds = bin->green_ds;
+                }
+            }
+        }
+
+        // y = (q4 / 4) veh/min * headway_ds / 600 ds/min, as a percentage
+        uint32_t y = ((uint32_t)q4 * ADAPTIVE_HEADWAY_DS) / 24;
+        y_pct[t] = (y > 100) ? 100 : y;
+        y_total += y_pct[t];
+        ad->plan.flow_vpm[t] = clamp(q4 / 4, 0, 0xFF);
+        ad->plan.flow_ratio_pct[t] = y_pct[t];
+        ad->plan.green_used_pct[t] = clamp(green_ds / 6, 0, 100);
+    }
+
+    if (y_total > ADAPTIVE_MAX_Y_PCT) {
+        y_total = ADAPTIVE_MAX_Y_PCT;
+    }
+
+    // Webster cycle, all in periods
+    uint32_t lost = (uint32_t)phases * ADAPTIVE_LOST_PERIODS;
+    uint32_t cycle = ((15 * lost) / 10 + 5000 / x->period_ms) * 100 / (100 - y_total);
+    if (cycle < ADAPTIVE_CYCLE_MIN) cycle = ADAPTIVE_CYCLE_MIN;
+    if (cycle > ADAPTIVE_CYCLE_MAX) cycle = ADAPTIVE_CYCLE_MAX;
+    ad->plan.cycle_periods = cycle;
+
+    // Split the effective green by flow ratio
+    uint32_t green = (cycle > lost) ? cycle - lost : 0;
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        adaptive_bounds_t b;
+        memcpy_P(&b, &bounds[t], sizeof(b));
+        uint16_t g = 0;
+        if (y_total) {
+            uint32_t share = green * y_pct[t] / y_total;
+            g = (share > 0xFF) ? 0xFF : share;
+        }
+        ad->plan.max_periods[t] = clamp(g, b.max_lo, b.max_hi);
+        ad->plan.min_periods[t] = clamp(g / 2, b.min_lo, b.min_hi);
+        if (ad->plan.min_periods[t] >= ad->plan.max_periods[t]) {
+            ad->plan.min_periods[t] = ad->plan.max_periods[t] - 1;
+        }
+    }
+}
+
+// Called when a cycle starts (the rest phase turning green)
+void adaptive_cycle(intersection_t *x) {
+    adaptive_t *ad = &adaptive[x->id];
+
+    if (!ad->on) {
+        return;
+    }
+
+    uint16_t minute = stats_minutes(x);
+    if (minute != ad->last_minute) {
+        ad->last_minute = minute;
+        replan(x, ad);
+    }
+    if (!ad->plan.cycle_periods) {
+        return;  // No measurements yet
+    }
+
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        x->timing[t].min_periods = ad->plan.min_periods[t];
+        x->timing[t].max_periods = ad->plan.max_periods[t];
+    }
+    if (ad->plan.applied < 0xFFFF) {
+        ad->plan.applied++;
+    }
+}
+
+const adaptive_plan_t* adaptive_get_plan(intersection_t *x) {
+    return &adaptive[x->id].plan;
+}
+
+// Write the plans to the host. Per intersection one step for the cycle,
+// then one per timing block: flow, flow ratio, green used and limits.
+enum ON adaptive_dump(uint16_t step) {
+    if (step == 0) {
+        host_puts_P(dump_header);
+        return TRUE;
+    }
+    uint8_t i = (step - 1) / (NUM_TIMINGS + 1);
+    uint8_t t = (step - 1) % (NUM_TIMINGS + 1);
+    const adaptive_t *ad = &adaptive[i];
+
+    if (t == 0) {
+        host_putc('x');
+        host_put_number(i);
+        host_puts_P(ad->on ? dump_on : dump_off);
+        host_put_number(ad->plan.cycle_periods);
+        host_putc(' ');
+        host_put_number(ad->plan.applied);
+        host_puts_P(dump_eol);
+        return TRUE;
+    }
+    t--;
+    host_putc(' ');
+    host_putc('t');
+    host_put_number(t);
+    host_putc(' ');
+    host_put_number(ad->plan.flow_vpm[t]);
+    host_putc(' ');
+    host_put_number(ad->plan.flow_ratio_pct[t]);
+    host_putc(' ');
+    host_put_number(ad->plan.green_used_pct[t]);
+    host_putc(' ');
+    host_put_number(ad->plan.min_periods[t]);
+    host_putc(' ');
+    host_put_number(ad->plan.max_periods[t]);
+    host_puts_P(dump_eol);
+    return (i + 1 < NUM_INTERSECTIONS || t + 1 < NUM_TIMINGS) ? TRUE : FALSE;
+}
@@ -0,0 +1,50 @@
+/*
+ * File:   adaptive.h
+ * Author: Traffic Light Controller
+ * 
+ * Adaptive split optimiser
+ */
+
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Optimiser runs from power up, the configuration's default
+#define ADAPTIVE_DEFAULT_ON     FALSE
+
+// Assumed saturation headway, 0.1 s per vehicle discharging on green
+#define ADAPTIVE_HEADWAY_DS     20
+
+// Lost time per phase (yellow plus all red), in periods
+#define ADAPTIVE_LOST_PERIODS   4
+
+// Highest total flow ratio planned for, in percent
+#define ADAPTIVE_MAX_Y_PCT      90
+
+// Cycle length limits, in periods
+#define ADAPTIVE_CYCLE_MIN      20
+#define ADAPTIVE_CYCLE_MAX      120
+
+// Current plan, for auditing the optimiser
+typedef struct {
+    uint16_t cycle_periods;                 // Webster cycle length
+    uint8_t flow_vpm[NUM_TIMINGS];          // Smoothed critical flow, vehicles/minute
+    uint8_t flow_ratio_pct[NUM_TIMINGS];    // Critical flow ratio y
+    uint8_t green_used_pct[NUM_TIMINGS];    // Green used last minute, share of the minute
+    uint8_t min_periods[NUM_TIMINGS];
+    uint8_t max_periods[NUM_TIMINGS];
+    uint16_t applied;                       // Plans applied at cycle boundaries
+} adaptive_plan_t;
+
+// Function prototypes
+void adaptive_init(intersection_t *x);
+const void *adaptive_preserved(uint16_t *len);
+void adaptive_enable(intersection_t *x, enum ON on);
+enum ON adaptive_enabled(intersection_t *x);
+void adaptive_cycle(intersection_t *x);
+const adaptive_plan_t* adaptive_get_plan(intersection_t *x);
+enum ON adaptive_dump(uint16_t step);
+
+#endif /* ADAPTIVE_H */
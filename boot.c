@@ -0,0 +1,46 @@
+/*
+ * File:   boot.c
+ * Author: Traffic Light Controller
+ * 
+ * Boot stage timing.
+ *
+ * Timer2 is the first thing main() starts, so each stage is timed from
+ * within a few microseconds of reset (only the C startup runs before it).
+ * Times are taken from micros(), to 8 us.
+ * boot_mark() can be called from an interrupt as well as the main loop,
+ * and only the first mark of each stage is kept.
+ */
+
+#include <xc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+#include "boot.h"
+
+static uint32_t stage_us[NUM_BOOT_STAGES];
+static uint8_t reached = 0;     // Stage bits marked so far
+
+void boot_mark(enum BOOT_STAGE stage) {
+    char cSREG = SREG;
+    cli();
+    if (!(reached & (1 << stage))) {
+        stage_us[stage] = micros();
+        reached |= (1 << stage);
+    }
+    SREG = cSREG;
+}
+
+enum ON boot_reached(enum BOOT_STAGE stage) {
+    return (reached & (1 << stage)) ? TRUE : FALSE;
+}
+
+// Time from BOOT_START to a stage, 0 if it hasn't been reached
+uint32_t boot_time_us(enum BOOT_STAGE stage) {
+    char cSREG = SREG;
+    cli();
+    uint32_t t = (reached & (1 << stage)) ? stage_us[stage] - stage_us[BOOT_START] : 0;
+    SREG = cSREG;
+    return t;
+}
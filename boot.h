@@ -0,0 +1,30 @@
+/*
+ * File:   boot.h
+ * Author: Traffic Light Controller
+ * 
+ * Boot stage timing
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+// Longest allowed time from reset to the first frame driven
+#define BOOT_TARGET_US  50000UL
+
+// Boot stages, in the order they are reached
+enum BOOT_STAGE {
+    BOOT_START,         // Clock running, times are measured from here
+    BOOT_OUTPUTS,       // Ports, expanders and the first frame ready
+    BOOT_FIRST_FRAME,   // First frame driven by the frame interrupt
+    BOOT_LCD,           // Display set up (never reached if there is none)
+    NUM_BOOT_STAGES
+};
+
+// Function prototypes
+void boot_mark(enum BOOT_STAGE stage);
+enum ON boot_reached(enum BOOT_STAGE stage);
+uint32_t boot_time_us(enum BOOT_STAGE stage);
+
+#endif /* BOOT_H */
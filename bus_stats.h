@@ -0,0 +1,72 @@
+/*
+ * File:   bus_stats.h
+ * Author: Traffic Light Controller
+ *
+ * Transaction, byte, error and busy time counters of a serial bus
+ *
+ * I2C.c and SPI.c each keep one of these. The running totals are added
+ * to as the bus is driven, bus_stats_roll() turns the growth since the
+ * last roll into the per second figures, and the errors of the interval,
+ * once every BUS_STATS_ROLL_MS.
+ */
+
+#ifndef BUS_STATS_H
+#define BUS_STATS_H
+
+#include <stdint.h>
+
+// Utilisation interval
+#define BUS_STATS_ROLL_MS   1000
+
+typedef struct {
+    // Running totals, the 32 bit ones wrap
+    uint32_t transactions;      // Start to stop, or select to deselect
+    uint32_t bytes;             // Bytes clocked, address bytes included
+    uint32_t busy_us;           // Start to stop, worked out from the bytes on SPI
+    uint16_t errors;            // NACKs, failed starts, write collisions
+
+    // Totals at the last roll
+    uint32_t rolled_transactions;
+    uint32_t rolled_bytes;
+    uint32_t rolled_busy_us;
+    uint16_t rolled_errors;
+
+    // Last complete interval, per second
+    uint16_t transactions_ps;
+    uint16_t bytes_ps;
+    uint8_t util_pct;           // Busy share of the interval
+    uint16_t errors_last;       // Errors in the interval, not per second
+} bus_stats_t;
+
+// Scale a count over elapsed_ms to per second, saturating
+static inline uint16_t bus_stats_rate(uint32_t count, uint16_t elapsed_ms) {
+    uint32_t rate = (count * 1000) / elapsed_ms;
+    return (rate > 0xFFFF) ? 0xFFFF : rate;
+}
+
+// Close an interval of elapsed_ms, interrupts off if an ISR drives the bus
+static inline void bus_stats_roll(bus_stats_t *b, uint16_t elapsed_ms) {
+    if (elapsed_ms == 0) {
+        return;
+    }
+    uint32_t busy = b->busy_us - b->rolled_busy_us;
+    uint32_t pct = busy / ((uint32_t)elapsed_ms * 10);
+
+    b->util_pct = (pct > 100) ? 100 : pct;
+    b->transactions_ps = bus_stats_rate(b->transactions - b->rolled_transactions, elapsed_ms);
+    b->bytes_ps = bus_stats_rate(b->bytes - b->rolled_bytes, elapsed_ms);
+    b->errors_last = b->errors - b->rolled_errors;
+    b->rolled_transactions = b->transactions;
+    b->rolled_bytes = b->bytes;
+    b->rolled_busy_us = b->busy_us;
+    b->rolled_errors = b->errors;
+}
+
+// Count an error without wrapping back to none
+static inline void bus_stats_error(bus_stats_t *b) {
+    if (b->errors < 0xFFFF) {
+        b->errors++;
+    }
+}
+
+#endif /* BUS_STATS_H */
@@ -0,0 +1,246 @@
+/*
+ * File:   config.c
+ * Author: Traffic Light Controller
+ * 
+ * Site configuration in EEPROM.
+ *
+ * The configuration (detector passage times, detector debounce, LCD
+ * addresses, timing plans, the time of day schedule, whether the split
+ * optimiser runs and the pressure selection's longest wait) is read once
+ * by config_init() into a RAM cache, and everything else reads the cache,
+ * never the EEPROM. The plans hold the only min and max green times.
+ * With no good record the compiled in defaults are used.
+ *
+ * The EEPROM holds CONFIG_SLOTS records, each with a layout version, a
+ * sequence number and a CRC. A save writes a new record into the slot
+ * after the newest one, so the writes are spread over every slot, and the
+ * CRC goes last. A save cut short by a reset leaves a record with a bad
+ * CRC, which is skipped, and the previous record is still the newest good
+ * one: the change is all or nothing.
+ *
+ * Most fields take effect as soon as they are read, so a record is only
+ * used if config_valid() passes every field: the newest record with a good
+ * CRC and good values is loaded, and with none the defaults are. Host
+ * edits are checked the same way before they reach the cache.
+ *
+ * An EEPROM byte takes 3.4 ms to write, so config_save() only starts a
+ * save. config_poll() writes one byte each time the EEPROM is ready, from
+ * the main loop, straight from the cache. The host refuses C edits while
+ * config_busy(), so a record can't take half of a change to a min and max
+ * pair. The CRC is of the bytes as they are written.
+ */
+
+#include <xc.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <util/crc16.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "Sensors.h"
+#include "sensor_manager.h"
+#include "tod.h"
+#include "LCD.h"
+#include "adaptive.h"
+#include "phase_select.h"
+#include "config.h"
+
+_Static_assert(sizeof(config_record_t) <= CONFIG_SLOT_SIZE, "configuration record does not fit a slot");
+_Static_assert(CONFIG_SLOT_SIZE * CONFIG_SLOTS <= E2END + 1, "configuration slots do not fit the EEPROM");
+
+#define SLOT_ADDR(slot) ((uint8_t *)(uintptr_t)((uint16_t)(slot) * CONFIG_SLOT_SIZE))
+#define CRC_OFFSET      offsetof(config_record_t, crc)
+#define CONFIG_OFFSET   offsetof(config_record_t, config)
+
+static config_t config;
+static enum ON from_eeprom = FALSE;
+
+static uint8_t next_slot = 0;           // Slot the next save goes to
+static uint16_t next_sequence = 0;
+
+// Save in progress
+static enum ON saving = FALSE;
+static uint8_t save_pos = 0;            // Next byte of the record
+static uint16_t save_crc = 0;
+
+// Load the compiled in defaults
+static void load_defaults(void) {
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        config.timing[t].passage_periods = pgm_read_byte(&default_timing[t].passage_periods);
+    }
+    config.debounce_ms = DEBOUNCE_TIME_MS;
+    memcpy_P(config.lcd_addrs, default_lcd_addrs, sizeof(config.lcd_addrs));
+    memcpy_P(config.plans, default_plans, sizeof(config.plans));
+    memcpy_P(config.schedule, default_schedule, sizeof(config.schedule));
+    config.adaptive_on = ADAPTIVE_DEFAULT_ON;
+    config.max_wait_s = SELECT_MAX_WAIT_S;
+}
+
+// A min/max pair in periods, a phase always gets some green and can extend
+static enum ON limits_valid(uint8_t min_periods, uint8_t max_periods) {
+    return (min_periods >= 1 && max_periods > min_periods) ? TRUE : FALSE;
+}
+
+// TRUE if every field is in range
+enum ON config_valid(const config_t *c) {
+    for (uint8_t i = 0; i < LCD_NUM_ADDRS; i++) {
+        uint8_t addr = c->lcd_addrs[i];
+        if (addr && (addr < CONFIG_LCD_ADDR_MIN || addr > CONFIG_LCD_ADDR_MAX)) {
+            return FALSE;
+        }
+    }
+    for (uint8_t p = 0; p < NUM_PLANS; p++) {
+        const timing_plan_t *plan = &c->plans[p];
+        for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+            // A passage has to fit inside every plan's max green
+            uint8_t passage = c->timing[t].passage_periods;
+            if (!limits_valid(plan->min_periods[t], plan->max_periods[t]) ||
+                passage < 1 || passage > plan->max_periods[t]) {
+                return FALSE;
+            }
+        }
+        if (plan->period_ms < CONFIG_PERIOD_MIN_MS || plan->period_ms > CONFIG_PERIOD_MAX_MS ||
+            plan->select_mode >= NUM_SELECT_MODES) {
+            return FALSE;
+        }
+    }
+    for (uint8_t i = 0; i < TOD_SCHEDULE_LEN; i++) {
+        const tod_entry_t *entry = &c->schedule[i];
+        if (entry->start_minute != TOD_UNUSED &&
+            (entry->start_minute >= CONFIG_MINUTES_PER_DAY || entry->plan >= NUM_PLANS)) {
+            return FALSE;
+        }
+    }
+    if (c->max_wait_s < CONFIG_MAX_WAIT_MIN_S || c->max_wait_s > CONFIG_MAX_WAIT_MAX_S) {
+        return FALSE;
+    }
+    return (c->adaptive_on <= TRUE) ? TRUE : FALSE;
+}
+
+// TRUE if a slot holds a good record of this layout
+static enum ON slot_valid(uint8_t slot) {
+    const uint8_t *p = SLOT_ADDR(slot);
+    uint16_t crc = 0xFFFF;
+
+    if (eeprom_read_byte(p) != CONFIG_VERSION) {
+        return FALSE;
+    }
+    for (uint8_t i = 0; i < CRC_OFFSET; i++) {
+        crc = _crc_ccitt_update(crc, eeprom_read_byte(p + i));
+    }
+    return (eeprom_read_word((const uint16_t *)(p + CRC_OFFSET)) == crc) ? TRUE : FALSE;
+}
+
+static uint16_t slot_sequence(uint8_t slot) {
+    return eeprom_read_word((const uint16_t *)(SLOT_ADDR(slot) + offsetof(config_record_t, sequence)));
+}
+
+// TRUE if a slot's values are all in range, leaves them in the cache
+static enum ON slot_usable(uint8_t slot) {
+    eeprom_read_block(&config, SLOT_ADDR(slot) + CONFIG_OFFSET, sizeof(config));
+    return config_valid(&config);
+}
+
+// Read the newest good record into the cache, at boot. A good CRC on bad
+// values (an older build, or a bad edit) is passed over for an older
+// record, but the next save still goes after the newest one written.
+void config_init(void) {
+    int16_t newest = -1;        // Newest good CRC, where saves carry on
+    int16_t usable = -1;        // Newest good CRC with good values
+    uint16_t sequence = 0;
+    uint16_t usable_sequence = 0;
+
+    for (uint8_t slot = 0; slot < CONFIG_SLOTS; slot++) {
+        if (!slot_valid(slot)) {
+            continue;
+        }
+        uint16_t s = slot_sequence(slot);
+        if (newest < 0 || (int16_t)(s - sequence) > 0) {
+            newest = slot;
+            sequence = s;
+        }
+        if ((usable < 0 || (int16_t)(s - usable_sequence) > 0) && slot_usable(slot)) {
+            usable = slot;
+            usable_sequence = s;
+        }
+    }
+
+    if (newest < 0) {
+        next_slot = 0;
+        next_sequence = 0;
+    } else {
+        next_slot = (newest + 1) % CONFIG_SLOTS;
+        next_sequence = sequence + 1;
+    }
+    if (usable < 0) {
+        load_defaults();
+        from_eeprom = FALSE;
+    } else {
+        slot_usable(usable);
+        from_eeprom = TRUE;
+    }
+    saving = FALSE;
+}
+
+// Configuration in force
+const config_t* config_get(void) {
+    return &config;
+}
+
+// Cache to change, the change is kept once config_save() has finished
+config_t* config_edit(void) {
+    return &config;
+}
+
+// TRUE if the configuration came from EEPROM rather than the defaults
+enum ON config_from_eeprom(void) {
+    return from_eeprom;
+}
+
+// Start writing the cache to the next slot, FALSE if a save is running
+enum ON config_save(void) {
+    if (saving) {
+        return FALSE;
+    }
+    save_pos = 0;
+    save_crc = 0xFFFF;
+    saving = TRUE;
+    return TRUE;
+}
+
+// Byte of the record being saved
+static uint8_t record_byte(uint8_t pos) {
+    if (pos == offsetof(config_record_t, version)) {
+        return CONFIG_VERSION;
+    }
+    if (pos < CONFIG_OFFSET) {
+        return next_sequence >> (8 * (pos - offsetof(config_record_t, sequence)));
+    }
+    if (pos < CRC_OFFSET) {
+        return ((const uint8_t *)&config)[pos - CONFIG_OFFSET];
+    }
+    return save_crc >> (8 * (pos - CRC_OFFSET));
+}
+
+// Write the next byte of a save, called from the main loop
+void config_poll(void) {
+    if (!saving || !eeprom_is_ready()) {
+        return;
+    }
+
+    uint8_t value = record_byte(save_pos);
+    if (save_pos < CRC_OFFSET) {
+        save_crc = _crc_ccitt_update(save_crc, value);
+    }
+    eeprom_update_byte(SLOT_ADDR(next_slot) + save_pos, value);
+
+    if (++save_pos >= sizeof(config_record_t)) {
+        saving = FALSE;
+        from_eeprom = TRUE;
+        next_slot = (next_slot + 1) % CONFIG_SLOTS;
+        next_sequence++;
+    }
+}
+
+enum ON config_busy(void) {
+    return saving;
+}
@@ -0,0 +1,67 @@
+/*
+ * File:   config.h
+ * Author: Traffic Light Controller
+ * 
+ * Site configuration in EEPROM
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdint.h>
+#include "Sensors.h"
+#include "tod.h"
+#include "LCD.h"
+
+// Layout version, records of any other version are ignored
+#define CONFIG_VERSION      4
+
+// Rotating records, the whole 1 KB EEPROM
+#define CONFIG_SLOT_SIZE    128
+#define CONFIG_SLOTS        8
+
+// Accepted ranges, a record or an edit outside them is refused
+#define CONFIG_PERIOD_MIN_MS    100         // Plan base period, the pot scales it to 1/20
+#define CONFIG_PERIOD_MAX_MS    10000
+#define CONFIG_LCD_ADDR_MIN     0x08        // 7 bit I2C addresses, 0 ends the list
+#define CONFIG_LCD_ADDR_MAX     0x77
+#define CONFIG_MINUTES_PER_DAY  1440
+#define CONFIG_MAX_WAIT_MIN_S   10          // Pressure selection's longest wait
+#define CONFIG_MAX_WAIT_MAX_S   600
+
+// Phase timing block. Its min and max green come from the timing plan in
+// force (plans[], tod.c), so they are only kept in one place.
+typedef struct {
+    uint8_t passage_periods;
+} config_timing_t;
+
+// Site configuration, cached in RAM
+typedef struct {
+    config_timing_t timing[NUM_TIMINGS];        // Indexed by enum TIMING
+    uint8_t debounce_ms;                        // Detector debounce
+    uint8_t lcd_addrs[LCD_NUM_ADDRS];           // LCD I2C addresses to probe
+    timing_plan_t plans[NUM_PLANS];             // Indexed by enum PLAN
+    tod_entry_t schedule[TOD_SCHEDULE_LEN];     // Time of day plan schedule
+    uint8_t adaptive_on;                        // Split optimiser runs, FALSE or TRUE
+    uint16_t max_wait_s;                        // Longest wait under SELECT_PRESSURE
+} config_t;
+
+// One record slot in EEPROM, the CRC covers everything before it
+typedef struct {
+    uint8_t version;
+    uint16_t sequence;      // Newest record has the highest, wraps
+    config_t config;
+    uint16_t crc;
+} config_record_t;
+
+// Function prototypes
+void config_init(void);
+const config_t* config_get(void);
+config_t* config_edit(void);
+enum ON config_valid(const config_t *c);
+enum ON config_from_eeprom(void);
+enum ON config_save(void);
+void config_poll(void);
+enum ON config_busy(void);
+
+#endif /* CONFIG_H */
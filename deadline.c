@@ -0,0 +1,133 @@
+/*
+ * File:   deadline.c
+ * Author: Traffic Light Controller
+ * 
+ * Start lateness of the main loop's periodic tasks.
+ *
+ * Each task runs once its period has passed since its last start, so a
+ * task held up by a long I2C transfer or another task starts late, and
+ * nothing shows it. deadline_start() is called as each task starts: its
+ * due time is the last start plus the period, and how far past that it
+ * is goes into a log2 histogram in microseconds, with the worst case
+ * since boot. The histograms are dumped to the host with "L".
+ */
+
+#include <xc.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+#include "host.h"
+#include "deadline.h"
+
+// Periods in microseconds, indexed by enum DEADLINE_TASK
+#define DEADLINE_PERIOD(name, label, period) (period) * 1000UL,
+static const uint32_t periods_us[NUM_DEADLINE_TASKS] PROGMEM = {
+    DEADLINE_TASKS(DEADLINE_PERIOD)
+};
+#undef DEADLINE_PERIOD
+
+#define DEADLINE_LABEL(name, label, period) static const char label_##name[] PROGMEM = label;
+DEADLINE_TASKS(DEADLINE_LABEL)
+#undef DEADLINE_LABEL
+
+#define DEADLINE_LABEL_PTR(name, label, period) label_##name,
+static const char *const labels[NUM_DEADLINE_TASKS] PROGMEM = {
+    DEADLINE_TASKS(DEADLINE_LABEL_PTR)
+};
+#undef DEADLINE_LABEL_PTR
+
+// Steps of a task's dump line, the counts then the buckets
+#define DEADLINE_DUMP_PARTS 3
+
+static const char dump_header[] PROGMEM = "task runs worst_us, then runs 0, 1, 2-3, 4-7 ... us late\r\n";
+static const char dump_eol[] PROGMEM = "\r\n";
+
+static deadline_t deadlines[NUM_DEADLINE_TASKS];
+
+// Bucket for a lateness: the number of bits it needs
+static uint8_t bucket(uint32_t late_us) {
+    uint8_t b = 0;
+
+    while (late_us && b < DEADLINE_BUCKETS - 1) {
+        late_us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+// Called as a task starts
+void deadline_start(enum DEADLINE_TASK task) {
+    deadline_t *d = &deadlines[task];
+    uint32_t now = micros();
+
+    if (d->runs) {
+        uint32_t late = now - d->last_start - pgm_read_dword(&periods_us[task]);
+
+        // Started early against the 1 ms clock the period is checked with
+        if ((int32_t)late < 0) {
+            late = 0;
+        }
+        uint16_t *count = &d->buckets[bucket(late)];
+        if (*count < 0xFFFF) {
+            (*count)++;
+        }
+        if (late > d->worst_us) {
+            d->worst_us = late;
+        }
+    }
+    if (d->runs < 0xFFFFFFFFUL) {
+        d->runs++;
+    }
+    d->last_start = now;
+}
+
+const deadline_t* deadline_get(enum DEADLINE_TASK task) {
+    if (task >= NUM_DEADLINE_TASKS) {
+        return 0;
+    }
+    return &deadlines[task];
+}
+
+// Clear the histograms, the worst cases and the run counts
+void deadline_reset(void) {
+    for (uint8_t t = 0; t < NUM_DEADLINE_TASKS; t++) {
+        for (uint8_t b = 0; b < DEADLINE_BUCKETS; b++) {
+            deadlines[t].buckets[b] = 0;
+        }
+        deadlines[t].worst_us = 0;
+        deadlines[t].runs = 0;
+    }
+}
+
+// Write each task's runs, worst case and buckets to the host. A task's
+// line is too long for one step, it goes out as the counts then the
+// buckets in DEADLINE_DUMP_PARTS - 1 parts.
+enum ON deadline_dump(uint16_t step) {
+    if (step == 0) {
+        host_puts_P(dump_header);
+        return TRUE;
+    }
+    uint8_t t = (step - 1) / DEADLINE_DUMP_PARTS;
+    uint8_t part = (step - 1) % DEADLINE_DUMP_PARTS;
+    const deadline_t *d = &deadlines[t];
+
+    if (part == 0) {
+        host_puts_P((const char*)pgm_read_ptr(&labels[t]));
+        host_putc(' ');
+        host_put_number(d->runs);
+        host_putc(' ');
+        host_put_number(d->worst_us);
+        return TRUE;
+    }
+    uint8_t per_part = DEADLINE_BUCKETS / (DEADLINE_DUMP_PARTS - 1);
+    for (uint8_t b = (part - 1) * per_part; b < part * per_part; b++) {
+        host_putc(' ');
+        host_put_number(d->buckets[b]);
+    }
+    if (part < DEADLINE_DUMP_PARTS - 1) {
+        return TRUE;
+    }
+    host_puts_P(dump_eol);
+    return (t + 1 < NUM_DEADLINE_TASKS) ? TRUE : FALSE;
+}
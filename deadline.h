@@ -0,0 +1,53 @@
+/*
+ * File:   deadline.h
+ * Author: Traffic Light Controller
+ * 
+ * Start lateness of the main loop's periodic tasks
+ */
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Task periods
+#define SCAN_PERIOD_MS      10
+#define STATE_PERIOD_MS     100
+#define FRAME_PERIOD_MS     20
+#define LCD_PERIOD_MS       200
+
+// Periodic tasks of the main loop
+// X(name, label, period)
+#define DEADLINE_TASKS(X) \
+    X(TASK_SCAN,  "scan",  SCAN_PERIOD_MS) \
+    X(TASK_STATE, "state", STATE_PERIOD_MS) \
+    X(TASK_FRAME, "frame", FRAME_PERIOD_MS) \
+    X(TASK_LCD,   "lcd",   LCD_PERIOD_MS)
+
+#define DEADLINE_ID(name, label, period) name,
+enum DEADLINE_TASK {
+    DEADLINE_TASKS(DEADLINE_ID)
+    NUM_DEADLINE_TASKS
+};
+#undef DEADLINE_ID
+
+// Lateness buckets: 0 is on time, bucket n is 2^(n-1) to 2^n - 1 us late,
+// the last one everything later
+#define DEADLINE_BUCKETS    16
+
+// Lateness of one task
+typedef struct {
+    uint16_t buckets[DEADLINE_BUCKETS];     // Runs in each bucket, saturating
+    uint32_t worst_us;                      // Latest start since boot
+    uint32_t runs;
+    uint32_t last_start;                    // micros() of the last run
+} deadline_t;
+
+// Function prototypes
+void deadline_start(enum DEADLINE_TASK task);
+const deadline_t* deadline_get(enum DEADLINE_TASK task);
+void deadline_reset(void);
+enum ON deadline_dump(uint16_t step);
+
+#endif /* DEADLINE_H */
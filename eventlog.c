@@ -0,0 +1,272 @@
+/*
+ * File:   eventlog.c
+ * Author: Traffic Light Controller
+ * 
+ * On-device event trace.
+ *
+ * Events go into a byte ring as variable length records:
+ *
+ *   event, argument, milliseconds since the previous record as a
+ *   base-128 varint (low 7 bits first, top bit set on all but the last)
+ *
+ * so a busy trace costs 3 bytes an event. When the ring is full the
+ * oldest records are dropped, and the time of the oldest one left is
+ * kept in first_ms. eventlog_add() can be called from an interrupt; it
+ * runs with interrupts off.
+ *
+ * Entering hazard flash freezes the trace once every intersection's entry
+ * has been recorded (eventlog_freeze()), so the events leading up to the
+ * hazard are kept for inspection with the "E" host command, which also
+ * shows the time of each. "E0" clears and restarts it. While a dump is
+ * going out nothing is recorded, but a freeze still takes effect.
+ *
+ * The ring and its indices are in .noinit, so the trace leading up to a
+ * watchdog, brown-out or reset button reset is still there afterwards.
+ * eventlog_init() keeps it if the reset wasn't a power on and the records
+ * walk cleanly from the oldest to the newest, otherwise it starts empty.
+ * After a warm restart the clock carries on (restart.c) and so do the
+ * times; after a cold one the clock starts again, and the records after
+ * the reset are timed on from the last one before it.
+ */
+
+#include <xc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+#include "host.h"
+#include "eventlog.h"
+
+#define EVENTLOG_LABEL(name, label) static const char label_##name[] PROGMEM = label;
+EVENTLOG_EVENTS(EVENTLOG_LABEL)
+#undef EVENTLOG_LABEL
+
+#define EVENTLOG_LABEL_PTR(name, label) label_##name,
+static const char *const labels[NUM_EVENTS] PROGMEM = {
+    EVENTLOG_EVENTS(EVENTLOG_LABEL_PTR)
+};
+#undef EVENTLOG_LABEL_PTR
+
+static const char dump_header[] PROGMEM = "ms event arg";
+static const char dump_frozen[] PROGMEM = " (frozen)";
+static const char dump_eol[] PROGMEM = "\r\n";
+
+#define VARINT_MAX  5               // Bytes of a 32 bit varint
+#define RECORD_MAX  (2 + VARINT_MAX)
+#define EVENTLOG_MAGIC  0x4576      // Set once the trace has been cleared
+
+// Kept across resets, only trusted once eventlog_init() has checked them
+static uint16_t magic __attribute__((section(".noinit")));
+static uint8_t ring[EVENTLOG_LEN] __attribute__((section(".noinit")));
+static uint16_t head __attribute__((section(".noinit")));       // Next byte written
+static uint16_t tail __attribute__((section(".noinit")));       // Oldest record
+static uint16_t used __attribute__((section(".noinit")));
+static uint32_t first_ms __attribute__((section(".noinit")));   // Time of the oldest record
+static uint32_t last_ms __attribute__((section(".noinit")));    // Time of the newest record
+static enum ON frozen __attribute__((section(".noinit")));
+
+// Cursor of the dump going out
+static uint16_t dump_i;
+static uint16_t dump_left = 0;
+static uint32_t dump_ms;
+static enum ON dumping = FALSE;  // Holds off recording, not kept
+
+static uint16_t next(uint16_t i) {
+    return (i + 1 < EVENTLOG_LEN) ? i + 1 : 0;
+}
+
+// Read a record's varint starting at *i, leaves *i after it
+static uint32_t read_varint(uint16_t *i) {
+    uint32_t value = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+
+    do {
+        b = ring[*i];
+        *i = next(*i);
+        value |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while ((b & 0x80) && shift < 7 * VARINT_MAX);
+    return value;
+}
+
+// TRUE if the indices agree and every record from the oldest reads back
+// whole, ending where the next one would be written
+static enum ON ring_valid(void) {
+    if (magic != EVENTLOG_MAGIC || head >= EVENTLOG_LEN || tail >= EVENTLOG_LEN ||
+        used > EVENTLOG_LEN || (tail + used) % EVENTLOG_LEN != head || frozen > TRUE) {
+        return FALSE;
+    }
+
+    uint16_t i = tail;
+    uint16_t left = used;
+    while (left) {
+        uint16_t start = i;
+        uint8_t n = 0;
+        uint8_t b;
+
+        if (left < 3 || ring[i] >= NUM_EVENTS) {
+            return FALSE;
+        }
+        i = next(next(i));
+        do {
+            b = ring[i];
+            i = next(i);
+            n++;
+        } while ((b & 0x80) && n < VARINT_MAX);
+
+        uint16_t len = (i - start + EVENTLOG_LEN) % EVENTLOG_LEN;
+        if ((b & 0x80) || len > left) {
+            return FALSE;
+        }
+        left -= len;
+    }
+    return TRUE;
+}
+
+// Drop the oldest record, the next one becomes the oldest
+static void drop_oldest(void) {
+    uint16_t i = next(next(tail));
+
+    read_varint(&i);                // Its own delta, from before the trace
+    used -= (i - tail + EVENTLOG_LEN) % EVENTLOG_LEN;
+    tail = i;
+    if (used) {
+        i = next(next(tail));
+        first_ms += read_varint(&i);
+    }
+}
+
+static void put(uint8_t b) {
+    ring[head] = b;
+    head = next(head);
+    used++;
+}
+
+// Record an event, from an interrupt or the main loop
+void eventlog_add(enum EVENT event, uint8_t arg) {
+    char cSREG = SREG;
+    cli();
+
+    if (!frozen && !dumping) {
+        uint32_t now = clock_count;
+        uint32_t delta = now - last_ms;
+
+        while (used && EVENTLOG_LEN - used < RECORD_MAX) {
+            drop_oldest();
+        }
+        if (!used) {
+            first_ms = now;
+            delta = 0;
+        }
+        put(event);
+        put(arg);
+        while (delta >= 0x80) {
+            put(delta | 0x80);
+            delta >>= 7;
+        }
+        put(delta);
+        last_ms = now;
+    }
+    SREG = cSREG;
+}
+
+// Stop recording until the trace is cleared, once hazard has been entered
+void eventlog_freeze(void) {
+    char cSREG = SREG;
+    cli();
+    frozen = TRUE;
+    SREG = cSREG;
+}
+
+// Keep the trace from before the reset if it can be trusted, at boot
+// before the first event and with interrupts still off
+void eventlog_init(uint8_t reset_cause) {
+    if ((reset_cause & _BV(PORF)) || !ring_valid()) {
+        eventlog_clear();
+    }
+
+    // Only a warm restart keeps the clock, time the next record on from
+    // the last one if it has gone back
+    uint32_t now = clock_count;
+    if ((int32_t)(now - last_ms) < 0) {
+        last_ms = now;
+    }
+}
+
+enum ON eventlog_frozen(void) {
+    return frozen;
+}
+
+// Empty the trace and start recording again
+void eventlog_clear(void) {
+    char cSREG = SREG;
+    cli();
+    head = 0;
+    tail = 0;
+    used = 0;
+    first_ms = 0;
+    last_ms = 0;
+    frozen = FALSE;
+    magic = EVENTLOG_MAGIC;
+    dump_left = 0;              // A dump going out ends here
+    dumping = FALSE;
+    SREG = cSREG;
+}
+
+// Write the trace to the host, oldest first, with absolute times. Step
+// 0 writes the header, each later step one record. Recording is held
+// off until the last record has gone out.
+enum ON eventlog_dump(uint16_t step) {
+    char cSREG;
+
+    if (step == 0) {
+        cSREG = SREG;
+        cli();
+        dumping = TRUE;
+        dump_i = tail;
+        dump_left = used;
+        dump_ms = first_ms;
+        SREG = cSREG;
+
+        host_puts_P(dump_header);
+        if (frozen) {
+            host_puts_P(dump_frozen);
+        }
+        host_puts_P(dump_eol);
+        return TRUE;
+    }
+
+    if (!dump_left) {
+        cSREG = SREG;
+        cli();
+        dumping = FALSE;
+        SREG = cSREG;
+        return FALSE;
+    }
+
+    uint16_t start = dump_i;
+    uint8_t event = ring[dump_i];
+    dump_i = next(dump_i);
+    uint8_t arg = ring[dump_i];
+    dump_i = next(dump_i);
+    uint32_t delta = read_varint(&dump_i);
+    dump_left -= (dump_i - start + EVENTLOG_LEN) % EVENTLOG_LEN;
+
+    if (step > 1) {
+        dump_ms += delta;
+    }
+    host_put_number(dump_ms);
+    host_putc(' ');
+    if (event < NUM_EVENTS) {
+        host_puts_P((const char*)pgm_read_ptr(&labels[event]));
+    } else {
+        host_put_number(event);
+    }
+    host_putc(' ');
+    host_put_number(arg);
+    host_puts_P(dump_eol);
+    return TRUE;
+}
@@ -0,0 +1,48 @@
+/*
+ * File:   eventlog.h
+ * Author: Traffic Light Controller
+ * 
+ * On-device event trace, frozen on hazard entry
+ */
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Trace ring size in bytes, a record takes 3 to 7
+#ifndef EVENTLOG_LEN
+#define EVENTLOG_LEN    256
+#endif
+
+// Events
+// X(name, label), the argument is described alongside
+#define EVENTLOG_EVENTS(X) \
+    X(EVENT_RESET,       "reset")       /* MCUSR */ \
+    X(EVENT_STATE,       "state")       /* id << 4 | enum STATE */ \
+    X(EVENT_SENSOR_ON,   "sensor+")     /* id << 4 | sensor */ \
+    X(EVENT_SENSOR_OFF,  "sensor-")     /* id << 4 | sensor */ \
+    X(EVENT_MONITOR,     "monitor")     /* id << 4 | approach, of a trip */ \
+    X(EVENT_HAZARD_ON,   "hazard+")     /* id */ \
+    X(EVENT_HAZARD_OFF,  "hazard-")     /* id */
+
+#define EVENTLOG_ID(name, label) name,
+enum EVENT {
+    EVENTLOG_EVENTS(EVENTLOG_ID)
+    NUM_EVENTS
+};
+#undef EVENTLOG_ID
+
+// Argument of the per intersection events
+#define EVENT_ARG(id, value)    (((id) << 4) | ((value) & 0x0F))
+
+// Function prototypes
+void eventlog_init(uint8_t reset_cause);
+void eventlog_add(enum EVENT event, uint8_t arg);
+void eventlog_freeze(void);
+enum ON eventlog_frozen(void);
+void eventlog_clear(void);
+enum ON eventlog_dump(uint16_t step);
+
+#endif /* EVENTLOG_H */
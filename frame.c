@@ -0,0 +1,107 @@
+/*
+ * File:   frame.c
+ * Author: Traffic Light Controller
+ * 
+ * Double buffered light output.
+ *
+ * The main loop builds a whole frame, every intersection's output bytes,
+ * in the back buffer with frame_set() and hands it over with
+ * frame_publish(), which just swaps the buffers. The Timer0 compare
+ * interrupt runs every millisecond and, if a frame has been published,
+ * writes all of it back to back: GPIOA, GPIOB and the lamp port of each
+ * intersection. A published frame reaches the lamps on the next
+ * millisecond tick, and a half built frame is never driven. Frames are
+ * only built when the main loop gets round to them, so they are as
+ * punctual as its longest pass; the LCD is written a few cells a pass
+ * (LCD.c) to keep that well under a frame. The interrupt only reads the
+ * front buffer and the main loop only writes the back one, so neither
+ * needs locking beyond the swap.
+ */
+
+#include <xc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "Sensors.h"
+#include "SPI.h"
+#include "intersection.h"
+#include "frame.h"
+#include "boot.h"
+#include "profile.h"
+#include "trace.h"
+
+static frame_t buffers[2][NUM_INTERSECTIONS];
+static frame_t *volatile front = buffers[0];    // Owned by the interrupt
+static frame_t *back = buffers[1];              // Owned by the main loop
+static volatile enum ON ready = FALSE;          // front holds a new frame
+static volatile uint16_t commits = 0;           // Frames driven, wraps
+
+ISR(TIMER0_COMPA_vect) {
+    TRACE_BEGIN(FRAME_ISR);
+    if (!ready) {
+        TRACE_END(FRAME_ISR);
+        return;
+    }
+    PROFILE_BEGIN(PROF_ISR_FRAME);
+    ready = FALSE;
+
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        const intersection_io_t *io = &io_map[i];
+        uint8_t addr = pgm_read_byte(&io->expander);
+        volatile uint8_t *port = (volatile uint8_t *)pgm_read_ptr(&io->lamp_port);
+
+        SPI_Send_Command_Addr(addr, 0x14, front[i].gpioa);
+        SPI_Send_Command_Addr(addr, 0x15, front[i].gpiob);
+        if (port) {
+            uint8_t mask = pgm_read_byte(&io->lamp_mask);
+            *port = (*port & ~mask) | front[i].port;
+        }
+    }
+    if (!commits) {
+        boot_mark(BOOT_FIRST_FRAME);
+    }
+    commits++;
+    PROFILE_END(PROF_ISR_FRAME);
+    TRACE_END(FRAME_ISR);
+}
+
+void setup_frame(void) {
+    TCCR0B = 0;                         // Stop the counter to configure
+    TCNT0 = 0;
+    OCR0A = FRAME_OCR0A;
+    TIFR0 = _BV(OCF0B) | _BV(OCF0A) | _BV(TOV0);
+    TIMSK0 = _BV(OCIE0A);               // Interrupt on compare A
+    TCCR0A = _BV(WGM01);                // CTC
+    TCCR0B = _BV(CS01) | _BV(CS00);     // clock/64, start
+}
+
+// Put an intersection's lights (from get_Lights()) into the back buffer
+void frame_set(intersection_t *x, uint32_t lights) {
+    frame_t *f = &back[x->id];
+    uint8_t mask = pgm_read_byte(&io_map[x->id].lamp_mask);
+
+    f->gpioa = lights & 0xFF;
+    f->gpiob = (lights >> 8) & 0xFF;
+    f->port = (lights >> 16) & mask;
+}
+
+// Hand the back buffer to the frame interrupt, once every intersection is set
+void frame_publish(void) {
+    char cSREG = SREG;
+    cli();
+    frame_t *f = front;
+    front = back;
+    back = f;
+    ready = TRUE;
+    SREG = cSREG;
+}
+
+// Frames driven, for checking the interrupt is running
+uint16_t frame_commits(void) {
+    char cSREG = SREG;
+    cli();
+    uint16_t n = commits;
+    SREG = cSREG;
+    return n;
+}
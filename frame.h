@@ -0,0 +1,30 @@
+/*
+ * File:   frame.h
+ * Author: Traffic Light Controller
+ * 
+ * Double buffered light output, committed by the Timer0 frame interrupt
+ */
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Timer0 CTC at clock/64: 250 counts is 1 ms
+#define FRAME_OCR0A     249
+
+// Output bytes of one intersection
+typedef struct {
+    uint8_t gpioa;      // Output bits 0-7
+    uint8_t gpiob;      // Output bits 8-15
+    uint8_t port;       // Output bits 16-23, masked to the lamp port
+} frame_t;
+
+// Function prototypes
+void setup_frame(void);
+void frame_set(intersection_t *x, uint32_t lights);
+void frame_publish(void);
+uint16_t frame_commits(void);
+
+#endif /* FRAME_H */
@@ -0,0 +1,91 @@
+/*
+ * File:   hazard.c
+ * Author: Traffic Light Controller
+ * 
+ * Interrupt driven hazard switch on PD3 (INT1).
+ *
+ * Entry is taken straight from the INT1 edge, so the very next output frame
+ * already shows hazard flash. Exit is owned by hazard_update(): every edge
+ * restarts the exit timer, so contact bounce on release just delays the
+ * exit, and the switch has to stay released for HAZARD_EXIT_MS. A conflict
+ * monitor fault holds hazard until the switch has been operated. The one
+ * switch covers every intersection.
+ */
+
+#include <xc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+#include "intersection.h"
+#include "monitor.h"
+#include "eventlog.h"
+#include "hazard.h"
+#include "profile.h"
+#include "trace.h"
+
+static volatile uint8_t hazard_switch = 0;        // Switch level from the last edge, 1 = on
+static volatile uint32_t hazard_last_edge = 0;    // Time of the last edge on PD3
+
+// Any change on PD3
+ISR(INT1_vect) {
+    uint32_t now = clock_count;   // Interrupts are already off in here
+
+    TRACE_BEGIN(HAZARD_ISR);
+    PROFILE_BEGIN(PROF_ISR_HAZARD);
+    hazard_last_edge = now;
+    if (!(PIND & _BV(3))) {
+        hazard_switch = 1;
+        monitor_clear_fault();
+        for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+            Hazard_Enter(&intersections[i], now);
+        }
+        eventlog_freeze();
+    } else {
+        hazard_switch = 0;
+    }
+    PROFILE_END(PROF_ISR_HAZARD);
+    TRACE_END(HAZARD_ISR);
+}
+
+void setup_hazard(uint32_t now) {
+    DDRD &= ~_BV(3);        // PD3 as input
+    PORTD |= _BV(3);        // with pull-up
+
+    hazard_switch = !(PIND & _BV(3));
+    hazard_last_edge = now;
+
+    // A warm restart may come up with the switch already on
+    if (hazard_switch) {
+        for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+            Hazard_Enter(&intersections[i], now);
+        }
+        eventlog_freeze();
+    }
+
+    EICRA |= _BV(ISC10);    // Any logical change on INT1
+    EIFR = _BV(INTF1);
+    EIMSK |= _BV(INT1);
+}
+
+// Called from the sensor scan, the only place hazard mode is left
+void hazard_update(uint32_t now) {
+    char cSREG;
+
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        intersection_t *x = &intersections[i];
+
+        if (!x->hazard) {
+            continue;
+        }
+
+        // Keep INT1 out until hazard is cleared, so an edge can't be lost
+        cSREG = SREG;
+        cli();
+        if (!hazard_switch && !monitor_faulted(x) && (now - hazard_last_edge) >= HAZARD_EXIT_MS) {
+            Hazard_Exit(x, now);
+        }
+        SREG = cSREG;
+    }
+}
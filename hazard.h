@@ -0,0 +1,20 @@
+/*
+ * File:   hazard.h
+ * Author: Traffic Light Controller
+ * 
+ * Hazard switch input (PD3 / INT1)
+ */
+
+#ifndef HAZARD_H
+#define HAZARD_H
+
+#include <stdint.h>
+
+// Switch must be released this long before normal operation resumes
+#define HAZARD_EXIT_MS 10000
+
+// Function prototypes
+void setup_hazard(uint32_t now);
+void hazard_update(uint32_t now);
+
+#endif /* HAZARD_H */
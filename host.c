@@ -0,0 +1,361 @@
+/*
+ * File:   host.c
+ * Author: Traffic Light Controller
+ * 
+ * Commands from a host on the serial port.
+ *
+ * The receive interrupt collects one line at a time, host_poll() runs it
+ * from the main loop. Lines received while one is waiting are dropped.
+ *
+ *   T hh:mm[:ss]   Set the time of day clock
+ *   D              Step the LCD through its views
+ *   C nnn vvv      Set byte nnn of the configuration cache to vvv, refused
+ *                  if it leaves a field out of range or a save is running
+ *   W              Write the configuration to EEPROM
+ *   P              Dump the execution profile, P0 clears it
+ *   L              Dump the task lateness histograms, L0 clears them
+ *
+ *   M0 / M1        Telemetry off / on
+ *   E              Dump the event trace, E0 clears and restarts it
+ *   A              Dump the split optimiser's plans
+ *   A0 / A1        Split optimiser off / on, W keeps it
+ *   S              Dump the phase selection mode and longest waits
+ *   B              Dump the bus priority log
+ *   V              Dump the last minute and quarter of approach statistics
+ *
+ * Everything sent goes through a ring buffer emptied by the UDRE
+ * interrupt, and nothing here waits for it. Binary frames (telemetry.c)
+ * are queued whole or not at all. The dumps are longer than the ring, so
+ * they go out a step at a time: host_dump_poll() runs the next step on
+ * each main loop pass once HOST_DUMP_STEP bytes are free, and the module
+ * keeps its own cursor between steps. A dump command while one is going
+ * out is ignored. A frame is never split by text, the decoder
+ * (tools/telemetry.py) shows anything outside a frame as text.
+ *
+ *   Frame: HOST_SYNC, type, length, payload, CRC-16/CCITT (low byte
+ *          first) of type, length and payload
+ */
+
+#include <xc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/crc16.h>
+#include <stdint.h>
+#include "Sensors.h"
+#include "tod.h"
+#include "LCD.h"
+#include "config.h"
+#include "profile.h"
+#include "deadline.h"
+#include "telemetry.h"
+#include "eventlog.h"
+#include "adaptive.h"
+#include "phase_select.h"
+#include "tsp.h"
+#include "stats.h"
+#include "trace.h"
+#include "intersection.h"
+#include "host.h"
+
+static volatile char rx_line[HOST_LINE_LEN + 1];
+static volatile uint8_t rx_len = 0;
+static volatile enum ON rx_ready = FALSE;
+
+// Transmit ring, the main loop adds at tx_head, the interrupt takes from tx_tail
+static uint8_t tx_buf[HOST_TX_LEN];
+static volatile uint8_t tx_head = 0;
+static volatile uint8_t tx_tail = 0;
+
+static const char reply_refused[] PROGMEM = "refused\r\n";
+
+// Dump going out, and its next step
+static host_dump_t dump = 0;
+static uint16_t dump_step = 0;
+
+ISR(USART_RX_vect) {
+    TRACE_BEGIN(HOST_ISR);
+    char c = UDR0;
+
+    if (rx_ready) {
+        // Previous command not run yet
+    } else if (c == '\r' || c == '\n') {
+        if (rx_len) {
+            rx_line[rx_len] = '\0';
+            rx_ready = TRUE;
+        }
+    } else if (rx_len < HOST_LINE_LEN) {
+        rx_line[rx_len++] = c;
+    }
+    TRACE_END(HOST_ISR);
+}
+
+// Transmitter ready for the next byte
+ISR(USART_UDRE_vect) {
+    TRACE_BEGIN(HOST_ISR);
+    uint8_t tail = tx_tail;
+
+    if (tail == tx_head) {
+        UCSR0B &= ~(1 << UDRIE0);   // Empty, wait for host_kick()
+    } else {
+        UDR0 = tx_buf[tail];
+        tx_tail = (tail + 1) & (HOST_TX_LEN - 1);
+    }
+    TRACE_END(HOST_ISR);
+}
+
+void setup_host(void) {
+    UBRR0 = HOST_UBRR;
+    UCSR0A = 0;
+    UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);     // 8N1
+    UCSR0B = (1 << RXEN0) | (1 << RXCIE0) | (1 << TXEN0);
+}
+
+// Bytes free in the transmit ring
+static uint8_t tx_room(void) {
+    return (tx_tail - tx_head - 1) & (HOST_TX_LEN - 1);
+}
+
+// Add a byte, the caller has checked there is room
+static void tx_add(uint8_t c) {
+    uint8_t head = tx_head;
+    tx_buf[head] = c;
+    tx_head = (head + 1) & (HOST_TX_LEN - 1);
+}
+
+// Start the interrupt on what has been added
+static void host_kick(void) {
+    char cSREG = SREG;
+    cli();
+    UCSR0B |= (1 << UDRIE0);
+    SREG = cSREG;
+}
+
+// Send a text character, dropped if the ring is full. Dump steps check
+// for room first, so only a step longer than HOST_DUMP_STEP loses any.
+void host_putc(char c) {
+    if (tx_room()) {
+        tx_add(c);
+        host_kick();
+    }
+}
+
+void host_puts(const char *s) {
+    while (*s) {
+        host_putc(*s++);
+    }
+}
+
+// Send a number in decimal
+void host_put_number(uint32_t value) {
+    char digits[10];
+    uint8_t n = 0;
+
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    while (n) {
+        host_putc(digits[--n]);
+    }
+}
+
+// Queue a whole binary frame, never waits. FALSE if it didn't fit.
+enum ON host_send_frame(uint8_t type, const void *payload, uint8_t len) {
+    const uint8_t *p = payload;
+    uint16_t crc = 0xFFFF;
+
+    if (tx_room() < (uint16_t)len + HOST_FRAME_OVERHEAD) {
+        return FALSE;
+    }
+    tx_add(HOST_SYNC);
+    tx_add(type);
+    tx_add(len);
+    crc = _crc_ccitt_update(crc, type);
+    crc = _crc_ccitt_update(crc, len);
+    for (uint8_t i = 0; i < len; i++) {
+        tx_add(p[i]);
+        crc = _crc_ccitt_update(crc, p[i]);
+    }
+    tx_add(crc);
+    tx_add(crc >> 8);
+    host_kick();
+    return TRUE;
+}
+
+// Start sending a dump, FALSE if one is already going out
+enum ON host_dump(host_dump_t fn) {
+    if (dump) {
+        return FALSE;
+    }
+    dump = fn;
+    dump_step = 0;
+    return TRUE;
+}
+
+// Send the next step of the dump if there is room, every main loop pass
+void host_dump_poll(void) {
+    if (dump && tx_room() >= HOST_DUMP_STEP) {
+        if (!dump(dump_step++)) {
+            dump = 0;
+        }
+    }
+}
+
+// Send a string held in program memory
+void host_puts_P(const char *s) {
+    char c;
+
+    while ((c = pgm_read_byte(s++))) {
+        host_putc(c);
+    }
+}
+
+// Read a decimal field of up to max_digits, returns the character after it
+static const char* read_number(const char *p, uint16_t *value, uint8_t max_digits) {
+    uint16_t v = 0;
+    uint8_t digits = 0;
+
+    while (*p >= '0' && *p <= '9' && digits < max_digits) {
+        v = v * 10 + (*p++ - '0');
+        digits++;
+    }
+    *value = digits ? v : 0xFFFF;
+    return p;
+}
+
+// T hh:mm[:ss]
+static void command_time(const char *p, uint32_t now) {
+    uint16_t h, m, s = 0;
+
+    while (*p == ' ') p++;
+    p = read_number(p, &h, 2);
+    if (*p++ != ':') return;
+    p = read_number(p, &m, 2);
+    if (*p == ':') {
+        p = read_number(p + 1, &s, 2);
+    }
+    if (h > 23 || m > 59 || s > 59) {
+        return;
+    }
+    tod_set((uint32_t)h * 3600 + (uint16_t)m * 60 + s, now);
+}
+
+// C nnn vvv, most fields take effect straight away. A plan's min and max
+// are stepped to at the next cycle boundary while it is the one in force
+// (tod.c), the detector passage times at the next cold start. The edit is
+// tried on a copy first and refused if it leaves any field out of range,
+// so a pair like a min and max has to be changed in the order that keeps
+// it valid. Edits are refused while a save is being written, so no record
+// mixes old and new.
+static void command_config(const char *p) {
+    uint16_t offset, value;
+    config_t staged;
+
+    while (*p == ' ') p++;
+    p = read_number(p, &offset, 3);
+    while (*p == ' ') p++;
+    read_number(p, &value, 3);
+    if (offset >= sizeof(config_t) || value > 0xFF || config_busy()) {
+        host_puts_P(reply_refused);
+        return;
+    }
+    staged = *config_get();
+    ((uint8_t *)&staged)[offset] = value;
+    if (!config_valid(&staged)) {
+        host_puts_P(reply_refused);
+        return;
+    }
+    ((uint8_t *)config_edit())[offset] = value;
+}
+
+// A0 / A1, every intersection, and in the configuration cache
+static void command_adaptive(enum ON on) {
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        adaptive_enable(&intersections[i], on);
+    }
+    config_edit()->adaptive_on = on;
+}
+
+// Run a received command, called from the main loop
+void host_poll(uint32_t now) {
+    char line[HOST_LINE_LEN + 1];
+
+    if (!rx_ready) {
+        return;
+    }
+    for (uint8_t i = 0; i <= rx_len; i++) {
+        line[i] = rx_line[i];
+    }
+    rx_len = 0;
+    rx_ready = FALSE;
+
+    switch (line[0]) {
+        case 'T':
+        case 't':
+            command_time(line + 1, now);
+            break;
+        case 'D':
+        case 'd':
+            lcd_set_view((lcd_get_view() + 1) % NUM_LCD_VIEWS);
+            break;
+        case 'C':
+        case 'c':
+            command_config(line + 1);
+            break;
+        case 'W':
+        case 'w':
+            config_save();
+            break;
+        case 'P':
+        case 'p':
+            if (line[1] == '0') {
+                profile_reset();
+            } else {
+                host_dump(profile_dump);
+            }
+            break;
+        case 'E':
+        case 'e':
+            if (line[1] == '0') {
+                eventlog_clear();
+            } else {
+                host_dump(eventlog_dump);
+            }
+            break;
+        case 'A':
+        case 'a':
+            if (line[1] == '0' || line[1] == '1') {
+                command_adaptive(line[1] == '1' ? TRUE : FALSE);
+            } else {
+                host_dump(adaptive_dump);
+            }
+            break;
+        case 'S':
+        case 's':
+            host_dump(select_dump);
+            break;
+        case 'B':
+        case 'b':
+            host_dump(tsp_dump);
+            break;
+        case 'V':
+        case 'v':
+            host_dump(stats_dump);
+            break;
+        case 'M':
+        case 'm':
+            telemetry_enable(line[1] == '0' ? FALSE : TRUE);
+            break;
+        case 'L':
+        case 'l':
+            if (line[1] == '0') {
+                deadline_reset();
+            } else {
+                host_dump(deadline_dump);
+            }
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * File:   host.h
+ * Author: Traffic Light Controller
+ * 
+ * Host serial link (USART0, PD0/PD1)
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// 38400 baud at 16 MHz
+#define HOST_UBRR       25
+
+// Longest command line, without the terminator
+#define HOST_LINE_LEN   23
+
+// Transmit ring, a power of two
+#define HOST_TX_LEN     128
+
+// Binary frame: sync, type, length, payload, 2 byte CRC
+#define HOST_SYNC           0xA5
+#define HOST_FRAME_OVERHEAD 5
+#define HOST_PAYLOAD_MAX    (HOST_TX_LEN - 1 - HOST_FRAME_OVERHEAD)
+
+// Most characters one step of a dump may write
+#define HOST_DUMP_STEP      64
+
+// Writes step n of a dump, returns FALSE once it has finished
+typedef enum ON (*host_dump_t)(uint16_t step);
+
+// Function prototypes
+void setup_host(void);
+void host_poll(uint32_t now);
+void host_putc(char c);
+void host_puts(const char *s);
+void host_puts_P(const char *s);
+void host_put_number(uint32_t value);
+enum ON host_send_frame(uint8_t type, const void *payload, uint8_t len);
+enum ON host_dump(host_dump_t fn);
+void host_dump_poll(void);
+
+#endif /* HOST_H */
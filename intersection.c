@@ -0,0 +1,99 @@
+/*
+ * File:   intersection.c
+ * Author: Traffic Light Controller
+ * 
+ * Intersection contexts and their I/O.
+ *
+ * Each intersection_t holds the whole state of one controller, so several
+ * junctions can be stepped from the one main loop. The pins each one uses
+ * come from its row of io_map (io_map.c): its own MCP23S17 (by hardware
+ * address) for the lower 16 output bits and four of the detectors, plus
+ * ATmega pins for the rest.
+ */
+
+#include <xc.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "Sensors.h"
+#include "SPI.h"
+#include "sensor_manager.h"
+#include "intersection.h"
+#include "config.h"
+
+// Kept through a reset for a warm restart (restart.c)
+intersection_t intersections[NUM_INTERSECTIONS] __attribute__((section(".noinit")));
+
+// Start an intersection in hazard flash
+void intersection_init(intersection_t *x, uint8_t id) {
+    x->id = id;
+    x->state = Hazard;
+    x->hazard = TRUE;
+    x->hazard_flash = TRUE;
+    x->hazard_toggle_time = 0;
+    x->light_colours = COLOUR_ALL(OFF);
+    x->light_demand = 0;
+    x->light_actuated = 0;
+    // Min and max are set from the timing plan by tod_init()
+    memcpy_P(x->timing, default_timing, sizeof(x->timing));
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        x->timing[t].passage_periods = config_get()->timing[t].passage_periods;
+    }
+    x->period_ms = 1000;
+    x->changing = FALSE;
+    x->next_phase = Default;
+    x->next_green = 0;
+    x->clearing = 0;
+    clear_all_sensors(x);
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        x->debounce[i].state = 0;
+        x->debounce[i].last_change = 0;
+    }
+}
+
+// Configure the port expander of an intersection
+void setup_intersection_io(intersection_t *x) {
+    setup_PortExpander_Addr(pgm_read_byte(&io_map[x->id].expander));
+}
+
+// Detector bits currently active (low), by sensor number
+uint8_t intersection_read_sensors(intersection_t *x) {
+    const intersection_io_t *io = &io_map[x->id];
+    uint8_t addr = pgm_read_byte(&io->expander);
+    uint8_t pressed = 0;
+    uint8_t gpioa = 0xFF;
+    uint8_t gpiob = 0xFF;
+    enum ON read_a = FALSE;
+    enum ON read_b = FALSE;
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        uint8_t mask = pgm_read_byte(&io->sensor[i].mask);
+        uint8_t level;
+
+        switch (pgm_read_byte(&io->sensor[i].source)) {
+            case IO_GPIOA:
+                // Each expander port is read at most once per scan
+                if (!read_a) {
+                    gpioa = SPI_Read_Command_Addr(addr, 0x12);
+                    read_a = TRUE;
+                }
+                level = gpioa;
+                break;
+            case IO_GPIOB:
+                if (!read_b) {
+                    gpiob = SPI_Read_Command_Addr(addr, 0x13);
+                    read_b = TRUE;
+                }
+                level = gpiob;
+                break;
+            case IO_PINB: level = PINB; break;
+            case IO_PINC: level = PINC; break;
+            case IO_PIND: level = PIND; break;
+            default:      level = 0xFF; break;
+        }
+        if (!(level & mask)) {
+            pressed |= (1 << i);
+        }
+    }
+    return pressed;
+}
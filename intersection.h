@@ -0,0 +1,78 @@
+/*
+ * File:   intersection.h
+ * Author: Traffic Light Controller
+ * 
+ * Controller context for one intersection, and its I/O mapping
+ */
+
+#ifndef INTERSECTION_H
+#define INTERSECTION_H
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "Sensors.h"
+#include "sensor_manager.h"
+
+// Intersections run from the main loop
+#ifndef NUM_INTERSECTIONS
+#define NUM_INTERSECTIONS 1
+#endif
+
+// Where a detector input is read from
+enum IO_SOURCE {
+    IO_NONE,
+    IO_GPIOA,   // Port expander GPIOA
+    IO_GPIOB,   // Port expander GPIOB
+    IO_PINB,
+    IO_PINC,
+    IO_PIND
+};
+
+// One detector input, active low
+typedef struct {
+    uint8_t source;     // enum IO_SOURCE
+    uint8_t mask;
+} io_bit_t;
+
+// I/O mapping of one intersection (program memory)
+typedef struct {
+    uint8_t expander;               // MCP23S17 hardware address, drives output bits 0-15
+    io_bit_t sensor[NUM_SENSORS];   // Detectors, by sensor number
+    volatile uint8_t *lamp_port;    // Port for output bits 16-23, 0 if none
+    uint8_t lamp_mask;              // Pins of lamp_port it drives
+} intersection_io_t;
+
+// Controller state of one intersection
+struct intersection {
+    uint8_t id;                         // Index into intersections[] and io_map[]
+    enum STATE state;
+    volatile enum ON hazard;
+    volatile enum ON hazard_flash;      // Yellows lit in this half of the flash
+    uint32_t hazard_toggle_time;
+    
+    // Light state, indexed by approach number (dms, prws, prwt, pres, rws)
+    uint16_t light_colours;             // Packed enum COLOUR per approach
+    uint8_t light_demand;               // Approach bits with a vehicle on the detector
+    uint8_t light_actuated;             // Approach bits actuated since the last tick
+    phase_timing_t timing[NUM_TIMINGS];
+    uint32_t period_ms;                 // Time period, plan base scaled by the pot
+    
+    // Phase change in progress
+    enum ON changing;
+    enum STATE next_phase;              // Phase to start once cleared
+    uint8_t next_green;                 // Movements it turns green
+    uint8_t clearing;                   // Movements running to red for it
+    
+    sensor_state_t sensors;
+    debounce_t debounce[NUM_SENSORS];
+};
+
+extern intersection_t intersections[NUM_INTERSECTIONS];
+extern const intersection_io_t io_map[NUM_INTERSECTIONS] PROGMEM;
+
+// Function prototypes
+void intersection_init(intersection_t *x, uint8_t id);
+void setup_intersection_io(intersection_t *x);
+uint8_t intersection_read_sensors(intersection_t *x);
+
+#endif /* INTERSECTION_H */
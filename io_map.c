@@ -0,0 +1,47 @@
+/*
+ * File:   io_map.c
+ * Author: Traffic Light Controller
+ * 
+ * Board wiring of each intersection, indexed by intersection id.
+ *
+ * Intersection 0 is the original board, wired as the topology describes
+ * (topology.h): MCP23S17 at address 0 and the lamps in output bits 16-23
+ * on port C. A second junction needs its own expander (A2-A0 strapped to
+ * a different address) and its own pins.
+ */
+
+#include <xc.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "Sensors.h"
+#include "intersection.h"
+
+// Detector wiring from the topology
+#define SENSOR_IO(name, source, bit) {source, _BV(bit)},
+
+// Output bits 16-23 used by the topology's lamps
+#define LAMP_PORT_BITS(name, label, dir, green, yellow, red, conflicts) \
+    | ((OUTPUT_BIT(green) | OUTPUT_BIT(yellow) | OUTPUT_BIT(red)) >> 16)
+#define LAMP_PORT_MASK ((uint8_t)(0 TOPOLOGY_APPROACHES(LAMP_PORT_BITS)))
+
+const intersection_io_t io_map[NUM_INTERSECTIONS] PROGMEM = {
+    {
+        0,
+        {TOPOLOGY_SENSORS(SENSOR_IO)},
+        &PORTC, LAMP_PORT_MASK
+    },
+#if NUM_INTERSECTIONS > 1
+    {
+        1,
+        {
+            {IO_GPIOA, _BV(0)},     // dms
+            {IO_GPIOA, _BV(4)},     // prws
+            {IO_GPIOB, _BV(0)},     // prwt
+            {IO_GPIOB, _BV(4)},     // pres
+            {IO_NONE, 0},           // rws
+            {IO_NONE, 0},           // bus
+        },
+        0, 0
+    },
+#endif
+};
@@ -14,26 +14,36 @@
 #include "POT.h"
 #include "I2C.h"
 #include "sensor_manager.h"
+#include "intersection.h"
+#include "phase_select.h"
+#include "tsp.h"
 #include "LCD.h"
-
-// Debug macros
-#define debug   (PORTD &= 0x00)
-#define debug1  (PORTD ^= 0b10000000)
-#define debug2  (PORTD ^= 0b01000000)
-#define debug3  (PORTD ^= 0b00100000)
-#define debug4  (PORTD ^= 0b00010000)
+#include "stats.h"
+#include "adaptive.h"
+#include "tod.h"
+#include "host.h"
+#include "monitor.h"
+#include "hazard.h"
+#include "frame.h"
+#include "restart.h"
+#include "boot.h"
+#include "stack.h"
+#include "config.h"
+#include "profile.h"
+#include "deadline.h"
+#include "telemetry.h"
+#include "eventlog.h"
 
 // Function prototypes
 void buttonPressed(void);
-void write_LEDs(uint16_t leds);
 void uint_to_string(uint32_t num, char* str, uint8_t width);
 void string_copy(char* dest, const char* src);
 
 // Global variables
 volatile enum ON button_int = FALSE;
-volatile uint32_t time_period_ms = 1000;  // Default 1 second
+volatile uint32_t time_period_ms = 1000;  // Period of the first intersection
+volatile uint16_t pot_period_ms = 1000;   // Pot setting, scales the plan period
 volatile uint32_t time_counter = 0;       // For LCD display
-uint32_t hazard_start_time = 0;
 uint32_t last_lcd_update = 0;
 
 
@@ -52,8 +62,8 @@ ISR(PCINT0_vect) {
 // ADC ISR for potentiometer reading
 ISR(ADC_vect) {
     uint16_t adc_value = ADC;
-    // Map ADC value (0-1023) to time period (50-1000 ms)
-    time_period_ms = 50 + ((uint32_t)adc_value * 950) / 1023;
+    // Map ADC value (0-1023) to a scale of 50-1000 ms per second
+    pot_period_ms = 50 + ((uint32_t)adc_value * 950) / 1023;
 }
 
 void setup_hardware(void) {
@@ -67,10 +77,10 @@ void setup_hardware(void) {
     PORTC &= ~0b00001110; // Start with LEDs off
     
     // Port D setup
-    DDRD |= 0b11110000;   // PD4-7 as outputs for debug LEDs
-    DDRD &= ~0b00001000;  // PD3 as input for hazard
-    PORTD &= ~0b11110000; // Turn off debug LEDs
-    PORTD |= 0b00001000;  // Enable pull-up on hazard input
+    DDRD |= 0b10110000;   // PD4, PD5, PD7 as outputs for trace probes (trace.h)
+    DDRD &= ~0b01000000;  // PD6 S5 bus sensor input
+    PORTD &= ~0b10110000; // Probes idle low
+    PORTD |= 0b01000000;  // Enable pull-up on S5
     
     // Setup interrupts
     PCMSK0 |= 0b00000001;  // Enable PCINT0 for S4
@@ -89,137 +99,163 @@ void setup_hardware(void) {
 
 void read_sensors(void) {
     // Update sensor states with debouncing
-    update_sensor_states();
-    
-    // Check hazard input directly (PD3)
-    if (!(PIND & (1<<3))) {
-        if (!HAZARD) {
-            HAZARD = TRUE;
-            hazard_start_time = millis();
-        }
-    } else if (HAZARD && ((millis() - hazard_start_time) > 10000)) {
-        HAZARD = FALSE;
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        update_sensor_states(&intersections[i]);
     }
 }
 
 void update_lcd(void) {
     lcd_update_display();
 }
-void write_LEDs(uint16_t leds) {
-    // Write to GPIOA (lower 8 bits)
-    SPI_Send_Command(0x14, (leds & 0xFF));
-    
-    // Write to GPIOB (upper 8 bits)
-    SPI_Send_Command(0x15, ((leds >> 8) & 0xFF));
-}
 int main(void) {
-    // Initialize hardware
-    setup_hardware();
+    // After a watchdog or brown-out reset carry on from the saved state
+    enum ON warm = restart_warm();
+    eventlog_init(restart_reset_cause());
+    eventlog_add(EVENT_RESET, restart_reset_cause());
+    
+    // Clock first, the boot stages are timed from here
     setupTimer2();
-    setupTimer1();
-
+    boot_mark(BOOT_START);
+    
+    // Light outputs first: ports and port expanders
+    setup_hardware();
     setup_SPI();
     setup_PortExpander();
-    setup_I2C();
-    lcd_init();  // Now properly implemented
+    config_init();
     
-    // Initialize states
-    HAZARD = TRUE;
-    state = Hazard;
-    hazard_start_time = millis();
-    clear_all_sensors();
+    // Initialize states, every intersection starts in hazard flash
+    // unless it is resuming, with its calls, plans, statistics and clock
+    // as they were
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        intersection_t *x = &intersections[i];
+        if (!warm) {
+            intersection_init(x, i);
+            select_init(x);
+            tsp_init(x);
+            stats_init(x, millis());
+            adaptive_init(x);
+        }
+        setup_intersection_io(x);
+        monitor_init(x, millis());
+        if (warm) {
+            monitor_resume(x, get_Lights(x), millis());
+        }
+    }
+    setup_hazard(millis());
+    if (!warm) {
+        tod_init(millis());
+    }
+    setup_frame();
     
-    // Initialize all lights to OFF for hazard (will flash)
-    PRWS.colour = OFF;
-    PRES.colour = OFF;
-    PRWT.colour = OFF;
-    RWS.colour = OFF;
-    DMS.colour = OFF;
+    // First frame, hazard flash (or the resumed lights), is driven on the
+    // first frame interrupt after sei()
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        intersection_t *x = &intersections[i];
+        frame_set(x, monitor_check(x, get_Lights(x), millis()));
+    }
+    frame_publish();
+    boot_mark(BOOT_OUTPUTS);
     
     // Enable interrupts
     sei();
-        while ((millis()) < 2000) {
-            ;
-    }
+    
+    // Slower peripherals, the LCD is brought up from the main loop
+    setupTimer1();
+    setup_profile();
+    setup_I2C();
+    setup_host();
+    telemetry_init();
+    restart_watchdog_start();
     uint32_t last_state_update = 0;
     uint32_t last_light_update = 0;
     uint32_t last_sensor_read = 0;
     uint32_t last_time_increment = 0;
-    lcd_clear();
+    uint32_t last_bus_roll = 0;
+    uint16_t last_commits = frame_commits();
     while (1) {
         uint32_t now = millis();
+        enum ON changed = FALSE;
+        if (!lcd_ready()) {
+            lcd_boot(now);
+        }
+        PROFILE_BEGIN(PROF_LCD);
+        lcd_flush();
+        PROFILE_END(PROF_LCD);
+        profile_poll();
+        stack_scan();
+        config_poll();
+        telemetry_poll(now);
+        host_dump_poll();
         if (button_int) {
             read_sensors();
+            changed = TRUE;
         }
-        // Check for transition out of hazard
-        if (HAZARD && !(PIND & (1<<3))) {
-            hazard_start_time = now;
-        } else if (HAZARD && (PIND & (1<<3)) && ((now - hazard_start_time) >= 10000)) {
-            // Exit hazard mode
-            HAZARD = FALSE;
-            state = Default;
-            
-            // Clear all sensor states
-            clear_all_sensors();
-            
-            // Set initial state for normal operation
-            PRWS.colour = GREEN;
-            PRES.colour = GREEN;
-            PRWT.colour = RED;
-            RWS.colour = RED;
-            DMS.colour = RED;
-            
-            timing_prws.green_start = now;
-            timing_prws.red_start = now;
-            timing_prwt.red_start = now;
-            timing_rws.red_start = now;
-            timing_dms.red_start = now;
-            
-            // Reset all demands
-            PRWS.on = FALSE;
-            PRES.on = FALSE;
-            PRWT.on = FALSE;
-            RWS.on = FALSE;
-            DMS.on = FALSE;
-            
-            // Reset phase done flags
-            PRWS.phaseDone = FALSE;
-            PRES.phaseDone = FALSE;
-            PRWT.phaseDone = TRUE;
-            RWS.phaseDone = TRUE;
-            DMS.phaseDone = TRUE;
-            
-            // Mark default sensors as handled
-            mark_phase_sensors_handled(Default);
-        }
-    
         // Read sensors every 10ms
-        if ((now - last_sensor_read) >= 10) {
+        if ((now - last_sensor_read) >= SCAN_PERIOD_MS) {
+            deadline_start(TASK_SCAN);
+            PROFILE_BEGIN(PROF_SCAN);
             read_sensors();
+            hazard_update(now);
+            PROFILE_END(PROF_SCAN);
+            host_poll(now);
             last_sensor_read = now;
+            restart_checkin(RESTART_TASK_SCAN);
+            changed = TRUE;
         }
         
         // Update state machine every 100ms
-        if ((now - last_state_update) >= 100) {
-            State_Manager();
+        if ((now - last_state_update) >= STATE_PERIOD_MS) {
+            deadline_start(TASK_STATE);
+            // Time period is the plan's base period scaled by the pot
+            char cSREG = SREG;
+            cli();
+            uint16_t pot = pot_period_ms;
+            SREG = cSREG;
+            PROFILE_BEGIN(PROF_STATE);
+            tod_update(now);
+            
+            for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+                intersection_t *x = &intersections[i];
+                x->period_ms = ((uint32_t)tod_period_ms(x) * pot) / 1000;
+                State_Manager(x);
+                stats_update(x, now);
+            }
+            PROFILE_END(PROF_STATE);
+            time_period_ms = intersections[0].period_ms;
             last_state_update = now;
+            restart_checkin(RESTART_TASK_STATE);
+            changed = TRUE;
            // clear_all_sensors();
 
         }
         
-        // Update lights every 20ms
-        if ((now - last_light_update) >= 20) {
-            uint32_t lights = get_Lights();
-            write_LEDs(lights);
-            lights = lights >> 16;
-            PORTC = (lights & 0x0f);
+        // Publish a light frame every 20ms, the frame interrupt drives it
+        if ((now - last_light_update) >= FRAME_PERIOD_MS) {
+            deadline_start(TASK_FRAME);
+            // Checked by the conflict monitor before it is published
+            PROFILE_BEGIN(PROF_FRAME);
+            for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+                intersection_t *x = &intersections[i];
+                frame_set(x, monitor_check(x, get_Lights(x), now));
+            }
+            frame_publish();
+            PROFILE_END(PROF_FRAME);
             last_light_update = now;
+            
+            // Only counts once the interrupt has driven the last frame
+            uint16_t commits = frame_commits();
+            if (commits != last_commits) {
+                restart_checkin(RESTART_TASK_FRAME);
+                last_commits = commits;
+            }
         }
         
         // Update LCD every 200ms
-        if ((now - last_lcd_update) >= 200) {
+        if ((now - last_lcd_update) >= LCD_PERIOD_MS) {
+            deadline_start(TASK_LCD);
             update_lcd();
             last_lcd_update = now;
+            restart_checkin(RESTART_TASK_LCD);
         }
         
         // Increment time counter every time period
@@ -231,7 +267,17 @@ int main(void) {
             last_time_increment = now;
         }
         
+        // Roll the bus counters into utilisation every second
+        if ((now - last_bus_roll) >= BUS_STATS_ROLL_MS) {
+            I2C_Stats_Roll(now - last_bus_roll);
+            SPI_Stats_Roll(now - last_bus_roll);
+            last_bus_roll = now;
+        }
         
+        // Keep the preserved state's checksum up to date
+        if (changed) {
+            restart_save();
+        }
     }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,257 @@
+/*
+ * File:   monitor.c
+ * Author: Traffic Light Controller
+ * 
+ * Conflict monitor on the output word.
+ *
+ * Every frame, between get_Lights() and frame_set(), the word about to be
+ * driven is decoded back into green and yellow approach bits and checked
+ * against its own conflict table. The table is the topology's separate
+ * monitor list, kept in flash, so it doesn't depend on the phase logic or
+ * on the conflicts column the sequencer uses. monitor_init() checks that
+ * the list is two way and matches that column made two way, and refuses
+ * to run a phase table that puts conflicting approaches in one phase. It
+ * also times each yellow and the gap between a conflicting approach going
+ * dark and a green starting, against the controller's 2 period rule less
+ * one frame of sampling error.
+ *
+ * On any failure hazard is entered and the flash word is returned in place
+ * of the frame, so the bad word is never driven. The fault is latched:
+ * hazard isn't left again until the hazard switch has been operated.
+ * Each intersection is monitored on its own, a trip only flashes the
+ * junction that faulted.
+ *
+ * Work per frame is a fixed number of table lookups, plus one pass over the
+ * conflicting approaches for each green that starts; the Timer2 count is
+ * sampled either side to record the cost.
+ */
+
+#include <xc.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "Sensors.h"
+#include "intersection.h"
+#include "monitor.h"
+#include "eventlog.h"
+
+// Output bits of each approach, [approach][0 = green, 1 = yellow]
+#define LAMP_ROW(name, label, dir, green, yellow, red, conflicts) \
+    {OUTPUT_BIT(green), OUTPUT_BIT(yellow)},
+static const uint32_t lamp_bits[NUM_APPROACHES][2] PROGMEM = {
+    TOPOLOGY_APPROACHES(LAMP_ROW)
+};
+#undef LAMP_ROW
+
+// Conflicts as listed in the topology, [approach]
+#define CONFLICT_ROW(name, label, dir, green, yellow, red, conflicts) conflicts,
+static const uint8_t listed_conflicts[NUM_APPROACHES] PROGMEM = {
+    TOPOLOGY_APPROACHES(CONFLICT_ROW)
+};
+#undef CONFLICT_ROW
+
+// Approaches never allowed to show green or yellow together, [approach]
+#define MONITOR_ROW(name, conflicts) [name] = conflicts,
+static const uint8_t conflict_mask[NUM_APPROACHES] PROGMEM = {
+    TOPOLOGY_MONITOR_CONFLICTS(MONITOR_ROW)
+};
+#undef MONITOR_ROW
+static enum ON bad_topology = FALSE;
+
+// Hazard flash: every yellow, or nothing
+#define FLASH_BIT(name, label, dir, green, yellow, red, conflicts) | OUTPUT_BIT(yellow)
+#define FLASH_ON    (0 TOPOLOGY_APPROACHES(FLASH_BIT))
+
+// Monitor state of one intersection
+typedef struct {
+    monitor_log_t log;
+    volatile enum ON faulted;
+    uint8_t prev_green;
+    uint8_t prev_yellow;
+    uint32_t yellow_since[NUM_APPROACHES];  // 0 = not timing a yellow
+    uint32_t last_active[NUM_APPROACHES];   // Last frame showing green or yellow
+} monitor_t;
+
+static monitor_t monitors[NUM_INTERSECTIONS];
+
+void monitor_init(intersection_t *x, uint32_t now) {
+    monitor_t *m = &monitors[x->id];
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        m->yellow_since[a] = 0;
+        m->last_active[a] = now;
+    }
+    m->prev_green = 0;
+    m->prev_yellow = 0;
+
+    // The monitor's list has to be two way and agree with the one the
+    // sequencer works from, a slip in either is never cleared
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        uint8_t mask = pgm_read_byte(&conflict_mask[a]);
+        uint8_t listed = pgm_read_byte(&listed_conflicts[a]);
+        uint8_t reverse = 0;
+        for (uint8_t c = 0; c < NUM_APPROACHES; c++) {
+            if (pgm_read_byte(&listed_conflicts[c]) & APPROACH_BIT(a)) {
+                listed |= APPROACH_BIT(c);
+            }
+            if (pgm_read_byte(&conflict_mask[c]) & APPROACH_BIT(a)) {
+                reverse |= APPROACH_BIT(c);
+            }
+        }
+        if ((mask & APPROACH_BIT(a)) || mask != reverse || mask != listed) {
+            bad_topology = TRUE;
+            m->log.last_fault = MONITOR_BAD_TABLE;
+            m->log.last_approach = a;
+        }
+    }
+
+    // No phase may run conflicting approaches, this fault is never cleared
+    for (uint8_t p = Default; p < NUM_STATES; p++) {
+        phase_def_t def;
+        get_phase(p, &def);
+        uint8_t runs = def.lead | def.overlap;
+        for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+            if ((runs & APPROACH_BIT(a)) && (runs & pgm_read_byte(&conflict_mask[a]))) {
+                bad_topology = TRUE;
+                m->log.last_fault = MONITOR_BAD_PHASE;
+                m->log.last_approach = a;
+            }
+        }
+    }
+}
+
+// Pick up the lights being shown after a warm restart. The greens and
+// yellows already on are not treated as starting, and the approaches
+// that are dark are taken as having had their all-red time, as the
+// restored state was checked before the reset.
+void monitor_resume(intersection_t *x, uint32_t lights, uint32_t now) {
+    monitor_t *m = &monitors[x->id];
+    uint32_t cleared = now - 2 * x->period_ms;
+
+    m->prev_green = 0;
+    m->prev_yellow = 0;
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        uint8_t bit = APPROACH_BIT(a);
+        if (lights & pgm_read_dword(&lamp_bits[a][0])) m->prev_green |= bit;
+        if (lights & pgm_read_dword(&lamp_bits[a][1])) m->prev_yellow |= bit;
+        m->yellow_since[a] = 0;
+        m->last_active[a] = ((m->prev_green | m->prev_yellow) & bit) ? now : cleared;
+    }
+}
+
+// Record a fault and switch to hazard flash
+static uint32_t trip(intersection_t *x, enum MONITOR_FAULT fault, uint8_t approach, uint32_t now) {
+    monitor_t *m = &monitors[x->id];
+
+    if (m->log.trips < 0xFFFF) {
+        m->log.trips++;
+    }
+    m->log.last_fault = fault;
+    m->log.last_approach = approach;
+    m->faulted = TRUE;
+    eventlog_add(EVENT_MONITOR, EVENT_ARG(x->id, approach));
+    Hazard_Enter(x, now);
+    eventlog_freeze();
+    return get_Lights(x);
+}
+
+// Check one frame, returns the word that is safe to drive
+static uint32_t check(intersection_t *x, uint32_t lights, uint32_t now) {
+    monitor_t *m = &monitors[x->id];
+    uint8_t green = 0;
+    uint8_t yellow = 0;
+    uint32_t min_ms = 2 * x->period_ms - MONITOR_FRAME_MS;
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        if (lights & pgm_read_dword(&lamp_bits[a][0])) green |= APPROACH_BIT(a);
+        if (lights & pgm_read_dword(&lamp_bits[a][1])) yellow |= APPROACH_BIT(a);
+    }
+    uint8_t active = green | yellow;
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        if (active & APPROACH_BIT(a)) {
+            m->last_active[a] = now;
+        }
+    }
+    
+    if (x->hazard) {
+        if (lights != 0 && lights != FLASH_ON) {
+            return trip(x, MONITOR_BAD_FLASH, 0, now);
+        }
+        // Flash yellows are not timed as clearance yellows
+        for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+            m->yellow_since[a] = 0;
+        }
+        m->prev_green = 0;
+        m->prev_yellow = 0;
+        return lights;
+    }
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        uint8_t bit = APPROACH_BIT(a);
+        uint8_t conflicts = pgm_read_byte(&conflict_mask[a]);
+
+        if ((active & bit) && (active & conflicts)) {
+            return trip(x, MONITOR_CONFLICT, a, now);
+        }
+
+        // Green has to end through yellow, and the yellow has to run its time
+        if ((m->prev_green & bit) && !((green | yellow) & bit)) {
+            return trip(x, MONITOR_NO_YELLOW, a, now);
+        }
+        if ((m->prev_green & bit) && (yellow & bit)) {
+            m->yellow_since[a] = now ? now : 1;
+        }
+        if ((m->prev_yellow & bit) && !(yellow & bit)) {
+            if (m->yellow_since[a] && (now - m->yellow_since[a]) < min_ms) {
+                return trip(x, MONITOR_SHORT_YELLOW, a, now);
+            }
+            m->yellow_since[a] = 0;
+        }
+
+        // A green may only start once its conflicts have had the all-red time
+        if ((green & bit) && !(m->prev_green & bit)) {
+            for (uint8_t c = 0; c < NUM_APPROACHES; c++) {
+                if ((conflicts & APPROACH_BIT(c)) && (now - m->last_active[c]) < min_ms) {
+                    return trip(x, MONITOR_SHORT_ALL_RED, a, now);
+                }
+            }
+        }
+    }
+
+    m->prev_green = green;
+    m->prev_yellow = yellow;
+    return lights;
+}
+
+// Called once per output frame with the word from get_Lights()
+uint32_t monitor_check(intersection_t *x, uint32_t lights, uint32_t now) {
+    monitor_t *m = &monitors[x->id];
+    uint8_t start = TCNT2;
+
+    lights = check(x, lights, now);
+
+    // Timer2 counts 0-124 every millisecond
+    uint8_t end = TCNT2;
+    uint8_t cost = (end >= start) ? end - start : end + 125 - start;
+    m->log.cost_last = cost;
+    if (cost > m->log.cost_max) {
+        m->log.cost_max = cost;
+    }
+    return lights;
+}
+
+enum ON monitor_faulted(intersection_t *x) {
+    return (monitors[x->id].faulted || bad_topology) ? TRUE : FALSE;
+}
+
+// Hazard switch operated, normal running may resume when it is released
+void monitor_clear_fault(void) {
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        monitors[i].faulted = FALSE;
+    }
+}
+
+const monitor_log_t* monitor_get_log(intersection_t *x) {
+    return &monitors[x->id].log;
+}
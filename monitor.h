@@ -0,0 +1,45 @@
+/*
+ * File:   monitor.h
+ * Author: Traffic Light Controller
+ * 
+ * Output conflict monitor
+ */
+
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Output frame length, also the allowance on measured yellow and all-red
+#define MONITOR_FRAME_MS    20
+
+// Reasons for a trip
+enum MONITOR_FAULT {
+    MONITOR_OK,
+    MONITOR_CONFLICT,       // Conflicting approaches green or yellow together
+    MONITOR_NO_YELLOW,      // Green went straight to red
+    MONITOR_SHORT_YELLOW,   // Yellow shorter than 2 periods
+    MONITOR_SHORT_ALL_RED,  // Green started too soon after a conflicting approach
+    MONITOR_BAD_FLASH,      // Hazard frame that isn't all yellow or all off
+    MONITOR_BAD_PHASE,      // Phase table runs conflicting approaches together
+    MONITOR_BAD_TABLE       // Monitor's conflict list disagrees with the topology
+};
+
+typedef struct {
+    uint16_t trips;             // Faults seen
+    uint8_t last_fault;         // enum MONITOR_FAULT
+    uint8_t last_approach;      // Approach that tripped it
+    uint8_t cost_last;          // Check time last frame, in 8 us ticks of Timer2
+    uint8_t cost_max;           // Worst check time seen
+} monitor_log_t;
+
+// Function prototypes
+void monitor_init(intersection_t *x, uint32_t now);
+void monitor_resume(intersection_t *x, uint32_t lights, uint32_t now);
+uint32_t monitor_check(intersection_t *x, uint32_t lights, uint32_t now);
+enum ON monitor_faulted(intersection_t *x);
+void monitor_clear_fault(void);
+const monitor_log_t* monitor_get_log(intersection_t *x);
+
+#endif /* MONITOR_H */
@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=main.c POT.c abs_clock.c Sensors.c SPI.c I2C.c LCD.c sensor_manager.c
+SOURCEFILES_QUOTED_IF_SPACED=main.c POT.c abs_clock.c Sensors.c SPI.c I2C.c LCD.c sensor_manager.c stats.c hazard.c tsp.c phase_select.c adaptive.c tod.c host.c monitor.c intersection.c io_map.c frame.c restart.c boot.c stack.c config.c profile.c deadline.c telemetry.c eventlog.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o ${OBJECTDIR}/POT.o ${OBJECTDIR}/abs_clock.o ${OBJECTDIR}/Sensors.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/I2C.o ${OBJECTDIR}/LCD.o ${OBJECTDIR}/sensor_manager.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d ${OBJECTDIR}/POT.o.d ${OBJECTDIR}/abs_clock.o.d ${OBJECTDIR}/Sensors.o.d ${OBJECTDIR}/SPI.o.d ${OBJECTDIR}/I2C.o.d ${OBJECTDIR}/LCD.o.d ${OBJECTDIR}/sensor_manager.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o ${OBJECTDIR}/POT.o ${OBJECTDIR}/abs_clock.o ${OBJECTDIR}/Sensors.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/I2C.o ${OBJECTDIR}/LCD.o ${OBJECTDIR}/sensor_manager.o ${OBJECTDIR}/stats.o ${OBJECTDIR}/hazard.o ${OBJECTDIR}/tsp.o ${OBJECTDIR}/phase_select.o ${OBJECTDIR}/adaptive.o ${OBJECTDIR}/tod.o ${OBJECTDIR}/host.o ${OBJECTDIR}/monitor.o ${OBJECTDIR}/intersection.o ${OBJECTDIR}/io_map.o ${OBJECTDIR}/frame.o ${OBJECTDIR}/restart.o ${OBJECTDIR}/boot.o ${OBJECTDIR}/stack.o ${OBJECTDIR}/config.o ${OBJECTDIR}/profile.o ${OBJECTDIR}/deadline.o ${OBJECTDIR}/telemetry.o ${OBJECTDIR}/eventlog.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d ${OBJECTDIR}/POT.o.d ${OBJECTDIR}/abs_clock.o.d ${OBJECTDIR}/Sensors.o.d ${OBJECTDIR}/SPI.o.d ${OBJECTDIR}/I2C.o.d ${OBJECTDIR}/LCD.o.d ${OBJECTDIR}/sensor_manager.o.d ${OBJECTDIR}/stats.o.d ${OBJECTDIR}/hazard.o.d ${OBJECTDIR}/tsp.o.d ${OBJECTDIR}/phase_select.o.d ${OBJECTDIR}/adaptive.o.d ${OBJECTDIR}/tod.o.d ${OBJECTDIR}/host.o.d ${OBJECTDIR}/monitor.o.d ${OBJECTDIR}/intersection.o.d ${OBJECTDIR}/io_map.o.d ${OBJECTDIR}/frame.o.d ${OBJECTDIR}/restart.o.d ${OBJECTDIR}/boot.o.d ${OBJECTDIR}/stack.o.d ${OBJECTDIR}/config.o.d ${OBJECTDIR}/profile.o.d ${OBJECTDIR}/deadline.o.d ${OBJECTDIR}/telemetry.o.d ${OBJECTDIR}/eventlog.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/main.o ${OBJECTDIR}/POT.o ${OBJECTDIR}/abs_clock.o ${OBJECTDIR}/Sensors.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/I2C.o ${OBJECTDIR}/LCD.o ${OBJECTDIR}/sensor_manager.o
+OBJECTFILES=${OBJECTDIR}/main.o ${OBJECTDIR}/POT.o ${OBJECTDIR}/abs_clock.o ${OBJECTDIR}/Sensors.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/I2C.o ${OBJECTDIR}/LCD.o ${OBJECTDIR}/sensor_manager.o ${OBJECTDIR}/stats.o ${OBJECTDIR}/hazard.o ${OBJECTDIR}/tsp.o ${OBJECTDIR}/phase_select.o ${OBJECTDIR}/adaptive.o ${OBJECTDIR}/tod.o ${OBJECTDIR}/host.o ${OBJECTDIR}/monitor.o ${OBJECTDIR}/intersection.o ${OBJECTDIR}/io_map.o ${OBJECTDIR}/frame.o ${OBJECTDIR}/restart.o ${OBJECTDIR}/boot.o ${OBJECTDIR}/stack.o ${OBJECTDIR}/config.o ${OBJECTDIR}/profile.o ${OBJECTDIR}/deadline.o ${OBJECTDIR}/telemetry.o ${OBJECTDIR}/eventlog.o
 
 # Source Files
-SOURCEFILES=main.c POT.c abs_clock.c Sensors.c SPI.c I2C.c LCD.c sensor_manager.c
+SOURCEFILES=main.c POT.c abs_clock.c Sensors.c SPI.c I2C.c LCD.c sensor_manager.c stats.c hazard.c tsp.c phase_select.c adaptive.c tod.c host.c monitor.c intersection.c io_map.c frame.c restart.c boot.c stack.c config.c profile.c deadline.c telemetry.c eventlog.c
 
 
 
@@ -158,6 +158,120 @@ ${OBJECTDIR}/sensor_manager.o: sensor_manager.c  .generated_files/flags/default/
 	@${RM} ${OBJECTDIR}/sensor_manager.o 
 	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/sensor_manager.o.d" -MT "${OBJECTDIR}/sensor_manager.o.d" -MT ${OBJECTDIR}/sensor_manager.o -o ${OBJECTDIR}/sensor_manager.o sensor_manager.c 
 	
+${OBJECTDIR}/stats.o: stats.c  .generated_files/flags/default/52ad92bdd3a6d3ec790c872194bdf393edf361da .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/stats.o.d 
+	@${RM} ${OBJECTDIR}/stats.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/stats.o.d" -MT "${OBJECTDIR}/stats.o.d" -MT ${OBJECTDIR}/stats.o -o ${OBJECTDIR}/stats.o stats.c 
+	
+${OBJECTDIR}/hazard.o: hazard.c  .generated_files/flags/default/4e8b4b4491d76788492a8b990383e854bf69286e .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/hazard.o.d 
+	@${RM} ${OBJECTDIR}/hazard.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/hazard.o.d" -MT "${OBJECTDIR}/hazard.o.d" -MT ${OBJECTDIR}/hazard.o -o ${OBJECTDIR}/hazard.o hazard.c 
+	
+${OBJECTDIR}/tsp.o: tsp.c  .generated_files/flags/default/a89469ac5f18c8c2ad2c62d225c668a97a430b12 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/tsp.o.d 
+	@${RM} ${OBJECTDIR}/tsp.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/tsp.o.d" -MT "${OBJECTDIR}/tsp.o.d" -MT ${OBJECTDIR}/tsp.o -o ${OBJECTDIR}/tsp.o tsp.c 
+	
+${OBJECTDIR}/phase_select.o: phase_select.c  .generated_files/flags/default/650cea8cee4503cdf6313f3008aa0fd3f6f1f67c .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/phase_select.o.d 
+	@${RM} ${OBJECTDIR}/phase_select.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/phase_select.o.d" -MT "${OBJECTDIR}/phase_select.o.d" -MT ${OBJECTDIR}/phase_select.o -o ${OBJECTDIR}/phase_select.o phase_select.c 
+	
+${OBJECTDIR}/adaptive.o: adaptive.c  .generated_files/flags/default/98a1b0f44621b4079d54b756a4d01cf242ea6346 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/adaptive.o.d 
+	@${RM} ${OBJECTDIR}/adaptive.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/adaptive.o.d" -MT "${OBJECTDIR}/adaptive.o.d" -MT ${OBJECTDIR}/adaptive.o -o ${OBJECTDIR}/adaptive.o adaptive.c 
+	
+${OBJECTDIR}/tod.o: tod.c  .generated_files/flags/default/48a54ba48f5328c71a23ecda2c649c546a1ccc9e .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/tod.o.d 
+	@${RM} ${OBJECTDIR}/tod.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/tod.o.d" -MT "${OBJECTDIR}/tod.o.d" -MT ${OBJECTDIR}/tod.o -o ${OBJECTDIR}/tod.o tod.c 
+	
+${OBJECTDIR}/host.o: host.c  .generated_files/flags/default/4b88d6b9dcebee50d1fb2cc9770a8ad2d5fc8d7a .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/host.o.d 
+	@${RM} ${OBJECTDIR}/host.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/host.o.d" -MT "${OBJECTDIR}/host.o.d" -MT ${OBJECTDIR}/host.o -o ${OBJECTDIR}/host.o host.c 
+	
+${OBJECTDIR}/monitor.o: monitor.c  .generated_files/flags/default/374608ac16a5c05acac49deddbe1207e3c43268b .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/monitor.o.d 
+	@${RM} ${OBJECTDIR}/monitor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/monitor.o.d" -MT "${OBJECTDIR}/monitor.o.d" -MT ${OBJECTDIR}/monitor.o -o ${OBJECTDIR}/monitor.o monitor.c 
+	
+${OBJECTDIR}/intersection.o: intersection.c  .generated_files/flags/default/f0619d96a2368b2dc3c147b00c61943e48f7195d .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/intersection.o.d 
+	@${RM} ${OBJECTDIR}/intersection.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/intersection.o.d" -MT "${OBJECTDIR}/intersection.o.d" -MT ${OBJECTDIR}/intersection.o -o ${OBJECTDIR}/intersection.o intersection.c 
+	
+${OBJECTDIR}/io_map.o: io_map.c  .generated_files/flags/default/eabb41ba19c6c9d5556f90dd2fcc5771df714c60 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/io_map.o.d 
+	@${RM} ${OBJECTDIR}/io_map.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/io_map.o.d" -MT "${OBJECTDIR}/io_map.o.d" -MT ${OBJECTDIR}/io_map.o -o ${OBJECTDIR}/io_map.o io_map.c 
+	
+${OBJECTDIR}/frame.o: frame.c  .generated_files/flags/default/6b176852039ddecac09e3a07c8bf542b178664ad .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/frame.o.d 
+	@${RM} ${OBJECTDIR}/frame.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/frame.o.d" -MT "${OBJECTDIR}/frame.o.d" -MT ${OBJECTDIR}/frame.o -o ${OBJECTDIR}/frame.o frame.c 
+	
+${OBJECTDIR}/restart.o: restart.c  .generated_files/flags/default/204c2f9ac416b887068016108bd3e41bd8640606 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/restart.o.d 
+	@${RM} ${OBJECTDIR}/restart.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/restart.o.d" -MT "${OBJECTDIR}/restart.o.d" -MT ${OBJECTDIR}/restart.o -o ${OBJECTDIR}/restart.o restart.c 
+	
+${OBJECTDIR}/boot.o: boot.c  .generated_files/flags/default/76b8cba64380bf7fd8c8329790844d30fa18ed8f .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/boot.o.d 
+	@${RM} ${OBJECTDIR}/boot.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/boot.o.d" -MT "${OBJECTDIR}/boot.o.d" -MT ${OBJECTDIR}/boot.o -o ${OBJECTDIR}/boot.o boot.c 
+	
+${OBJECTDIR}/stack.o: stack.c  .generated_files/flags/default/5832739819bcfd9974b9940819407c8381984e3 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/stack.o.d 
+	@${RM} ${OBJECTDIR}/stack.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/stack.o.d" -MT "${OBJECTDIR}/stack.o.d" -MT ${OBJECTDIR}/stack.o -o ${OBJECTDIR}/stack.o stack.c 
+	
+${OBJECTDIR}/config.o: config.c  .generated_files/flags/default/f8f3019161704fb8cd96f8beae1a80751056b5c9 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/config.o.d 
+	@${RM} ${OBJECTDIR}/config.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/config.o.d" -MT "${OBJECTDIR}/config.o.d" -MT ${OBJECTDIR}/config.o -o ${OBJECTDIR}/config.o config.c 
+	
+${OBJECTDIR}/profile.o: profile.c  .generated_files/flags/default/e02df1ecf6196db288a170c6b4fe88d9ef11335f .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/profile.o.d 
+	@${RM} ${OBJECTDIR}/profile.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/profile.o.d" -MT "${OBJECTDIR}/profile.o.d" -MT ${OBJECTDIR}/profile.o -o ${OBJECTDIR}/profile.o profile.c 
+	
+${OBJECTDIR}/deadline.o: deadline.c  .generated_files/flags/default/948c18e38155c5db57243f58e03f5513677cd335 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/deadline.o.d 
+	@${RM} ${OBJECTDIR}/deadline.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/deadline.o.d" -MT "${OBJECTDIR}/deadline.o.d" -MT ${OBJECTDIR}/deadline.o -o ${OBJECTDIR}/deadline.o deadline.c 
+	
+${OBJECTDIR}/telemetry.o: telemetry.c  .generated_files/flags/default/9beb9d00caedc071a7002fba154d87cdfc1744ea .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/telemetry.o.d 
+	@${RM} ${OBJECTDIR}/telemetry.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/telemetry.o.d" -MT "${OBJECTDIR}/telemetry.o.d" -MT ${OBJECTDIR}/telemetry.o -o ${OBJECTDIR}/telemetry.o telemetry.c 
+	
+${OBJECTDIR}/eventlog.o: eventlog.c  .generated_files/flags/default/5386122a754cae4ccfdbf17c48bc72c0cdb36e72 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/eventlog.o.d 
+	@${RM} ${OBJECTDIR}/eventlog.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1 -g -DDEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -gdwarf-2  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/eventlog.o.d" -MT "${OBJECTDIR}/eventlog.o.d" -MT ${OBJECTDIR}/eventlog.o -o ${OBJECTDIR}/eventlog.o eventlog.c 
+	
 else
 ${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/aa79436818b2c0a0755c6c50132f6d215f6d39b9 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
@@ -207,6 +321,120 @@ ${OBJECTDIR}/sensor_manager.o: sensor_manager.c  .generated_files/flags/default/
 	@${RM} ${OBJECTDIR}/sensor_manager.o 
 	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/sensor_manager.o.d" -MT "${OBJECTDIR}/sensor_manager.o.d" -MT ${OBJECTDIR}/sensor_manager.o -o ${OBJECTDIR}/sensor_manager.o sensor_manager.c 
 	
+${OBJECTDIR}/stats.o: stats.c  .generated_files/flags/default/91a6628ccb03d0ebc78f996c760b492cb544b9e9 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/stats.o.d 
+	@${RM} ${OBJECTDIR}/stats.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/stats.o.d" -MT "${OBJECTDIR}/stats.o.d" -MT ${OBJECTDIR}/stats.o -o ${OBJECTDIR}/stats.o stats.c 
+	
+${OBJECTDIR}/hazard.o: hazard.c  .generated_files/flags/default/62681d15d7b2c2c6571b3cfe0060c383a06d5c64 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/hazard.o.d 
+	@${RM} ${OBJECTDIR}/hazard.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/hazard.o.d" -MT "${OBJECTDIR}/hazard.o.d" -MT ${OBJECTDIR}/hazard.o -o ${OBJECTDIR}/hazard.o hazard.c 
+	
+${OBJECTDIR}/tsp.o: tsp.c  .generated_files/flags/default/c2d68e52cd97321d239d2327af89d5c91e1ee1f3 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/tsp.o.d 
+	@${RM} ${OBJECTDIR}/tsp.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/tsp.o.d" -MT "${OBJECTDIR}/tsp.o.d" -MT ${OBJECTDIR}/tsp.o -o ${OBJECTDIR}/tsp.o tsp.c 
+	
+${OBJECTDIR}/phase_select.o: phase_select.c  .generated_files/flags/default/3ab366d74440833a7532a3dad8c0d9788fd4a5a7 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/phase_select.o.d 
+	@${RM} ${OBJECTDIR}/phase_select.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/phase_select.o.d" -MT "${OBJECTDIR}/phase_select.o.d" -MT ${OBJECTDIR}/phase_select.o -o ${OBJECTDIR}/phase_select.o phase_select.c 
+	
+${OBJECTDIR}/adaptive.o: adaptive.c  .generated_files/flags/default/61f30b9ff4695c40777ac43c802f47c9d804fdf .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/adaptive.o.d 
+	@${RM} ${OBJECTDIR}/adaptive.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/adaptive.o.d" -MT "${OBJECTDIR}/adaptive.o.d" -MT ${OBJECTDIR}/adaptive.o -o ${OBJECTDIR}/adaptive.o adaptive.c 
+	
+${OBJECTDIR}/tod.o: tod.c  .generated_files/flags/default/30aec656af37a9834180cdf16e55cb893eabc20f .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/tod.o.d 
+	@${RM} ${OBJECTDIR}/tod.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/tod.o.d" -MT "${OBJECTDIR}/tod.o.d" -MT ${OBJECTDIR}/tod.o -o ${OBJECTDIR}/tod.o tod.c 
+	
+${OBJECTDIR}/host.o: host.c  .generated_files/flags/default/8b4c124dbdb091eb5fd68e29e50c1da74c10d4c1 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/host.o.d 
+	@${RM} ${OBJECTDIR}/host.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/host.o.d" -MT "${OBJECTDIR}/host.o.d" -MT ${OBJECTDIR}/host.o -o ${OBJECTDIR}/host.o host.c 
+	
+${OBJECTDIR}/monitor.o: monitor.c  .generated_files/flags/default/5b188888201020481f2894f7b17796753566a4fa .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/monitor.o.d 
+	@${RM} ${OBJECTDIR}/monitor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/monitor.o.d" -MT "${OBJECTDIR}/monitor.o.d" -MT ${OBJECTDIR}/monitor.o -o ${OBJECTDIR}/monitor.o monitor.c 
+	
+${OBJECTDIR}/intersection.o: intersection.c  .generated_files/flags/default/a880c3a92ff64eb6c1f62faf6b8cf0b82642a68a .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/intersection.o.d 
+	@${RM} ${OBJECTDIR}/intersection.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/intersection.o.d" -MT "${OBJECTDIR}/intersection.o.d" -MT ${OBJECTDIR}/intersection.o -o ${OBJECTDIR}/intersection.o intersection.c 
+	
+${OBJECTDIR}/io_map.o: io_map.c  .generated_files/flags/default/f53a196edf825eeee98dba2a6f9e60ced64054c2 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/io_map.o.d 
+	@${RM} ${OBJECTDIR}/io_map.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/io_map.o.d" -MT "${OBJECTDIR}/io_map.o.d" -MT ${OBJECTDIR}/io_map.o -o ${OBJECTDIR}/io_map.o io_map.c 
+	
+${OBJECTDIR}/frame.o: frame.c  .generated_files/flags/default/462f4a43e56f615e7b651a05f1f8f902c55bd22a .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/frame.o.d 
+	@${RM} ${OBJECTDIR}/frame.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/frame.o.d" -MT "${OBJECTDIR}/frame.o.d" -MT ${OBJECTDIR}/frame.o -o ${OBJECTDIR}/frame.o frame.c 
+	
+${OBJECTDIR}/restart.o: restart.c  .generated_files/flags/default/f9d0e33ddcbf97db3ab8c23e70f06d56da5ff9ae .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/restart.o.d 
+	@${RM} ${OBJECTDIR}/restart.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/restart.o.d" -MT "${OBJECTDIR}/restart.o.d" -MT ${OBJECTDIR}/restart.o -o ${OBJECTDIR}/restart.o restart.c 
+	
+${OBJECTDIR}/boot.o: boot.c  .generated_files/flags/default/fd9bc8bbf4172cde9d582b2cb8d71182034af8fe .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/boot.o.d 
+	@${RM} ${OBJECTDIR}/boot.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/boot.o.d" -MT "${OBJECTDIR}/boot.o.d" -MT ${OBJECTDIR}/boot.o -o ${OBJECTDIR}/boot.o boot.c 
+	
+${OBJECTDIR}/stack.o: stack.c  .generated_files/flags/default/111ff7572ae6da067b4d1ec28a70fd98ec3a5652 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/stack.o.d 
+	@${RM} ${OBJECTDIR}/stack.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/stack.o.d" -MT "${OBJECTDIR}/stack.o.d" -MT ${OBJECTDIR}/stack.o -o ${OBJECTDIR}/stack.o stack.c 
+	
+${OBJECTDIR}/config.o: config.c  .generated_files/flags/default/7d98844d23c2dd880e2c693796ca8db30ec4ef7f .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/config.o.d 
+	@${RM} ${OBJECTDIR}/config.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/config.o.d" -MT "${OBJECTDIR}/config.o.d" -MT ${OBJECTDIR}/config.o -o ${OBJECTDIR}/config.o config.c 
+	
+${OBJECTDIR}/profile.o: profile.c  .generated_files/flags/default/7a43cc1a2480e165e4014dce8da538caaca0165c .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/profile.o.d 
+	@${RM} ${OBJECTDIR}/profile.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/profile.o.d" -MT "${OBJECTDIR}/profile.o.d" -MT ${OBJECTDIR}/profile.o -o ${OBJECTDIR}/profile.o profile.c 
+	
+${OBJECTDIR}/deadline.o: deadline.c  .generated_files/flags/default/60128743f0a967f5d93cdf34744d54741f972ad2 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/deadline.o.d 
+	@${RM} ${OBJECTDIR}/deadline.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/deadline.o.d" -MT "${OBJECTDIR}/deadline.o.d" -MT ${OBJECTDIR}/deadline.o -o ${OBJECTDIR}/deadline.o deadline.c 
+	
+${OBJECTDIR}/telemetry.o: telemetry.c  .generated_files/flags/default/416f1f8f457d875352a1d0a8e5987b8ab22b1295 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/telemetry.o.d 
+	@${RM} ${OBJECTDIR}/telemetry.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/telemetry.o.d" -MT "${OBJECTDIR}/telemetry.o.d" -MT ${OBJECTDIR}/telemetry.o -o ${OBJECTDIR}/telemetry.o telemetry.c 
+	
+${OBJECTDIR}/eventlog.o: eventlog.c  .generated_files/flags/default/11f1526074975609f5b4f79aced86c7cc4edf7ce .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/eventlog.o.d 
+	@${RM} ${OBJECTDIR}/eventlog.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -x c -D__$(MP_PROCESSOR_OPTION)__   -mdfp="${DFP_DIR}/xc8"  -Wl,--gc-sections -O1 -ffunction-sections -fdata-sections -fshort-enums -fno-common -funsigned-char -funsigned-bitfields -Wall -DXPRJ_default=$(CND_CONF)  $(COMPARISON_BUILD)  -gdwarf-3 -mno-const-data-in-progmem     -MD -MP -MF "${OBJECTDIR}/eventlog.o.d" -MT "${OBJECTDIR}/eventlog.o.d" -MT ${OBJECTDIR}/eventlog.o -o ${OBJECTDIR}/eventlog.o eventlog.c 
+	
 endif
 
 # ------------------------------------------------------------------------------------
@@ -0,0 +1,199 @@
+/*
+ * File:   phase_select.c
+ * Author: Traffic Light Controller
+ * 
+ * Chooses the next phase once the running one has cleared.
+ *
+ * SELECT_FIXED serves the called phase with the highest phase_table
+ * priority, which is the original Dam > Railway > Turn > Default order.
+ *
+ * SELECT_PRESSURE scores each called phase by the demand it would serve:
+ * the time each of its approaches has been waiting plus SELECT_VEHICLE_DS
+ * for every vehicle that has arrived on red. Any approach that has waited
+ * the configuration's max_wait_s wins outright, longest wait first, so no
+ * phase can starve. In both modes the rest phase is returned when nothing
+ * is called. The mode comes from the timing plan in force (tod.c).
+ *
+ * The longest call-to-green wait of each phase is kept for the host dump.
+ */
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "Sensors.h"
+#include "intersection.h"
+#include "config.h"
+#include "host.h"
+#include "phase_select.h"
+
+// Phase selection state of one intersection
+typedef struct {
+    enum SELECT_MODE mode;
+    uint32_t call_since[NUM_APPROACHES];    // 0 = no call waiting
+    uint8_t queued[NUM_APPROACHES];         // Vehicles arrived on red
+    uint16_t max_wait_ds[NUM_STATES];       // Longest call-to-green seen per phase
+} select_t;
+
+// Kept across a warm restart (restart.c)
+static select_t selects[NUM_INTERSECTIONS] __attribute__((section(".noinit")));
+
+static const char dump_header[] PROGMEM = "id mode, then longest wait per phase (0.1 s)\r\n";
+static const char dump_fixed[] PROGMEM = " fixed";
+static const char dump_pressure[] PROGMEM = " pressure";
+static const char dump_eol[] PROGMEM = "\r\n";
+
+void select_init(intersection_t *x) {
+    select_t *sel = &selects[x->id];
+
+    sel->mode = SELECT_DEFAULT_MODE;
+    for (uint8_t p = 0; p < NUM_STATES; p++) {
+        sel->max_wait_ds[p] = 0;
+    }
+    select_reset(x);
+}
+
+void select_reset(intersection_t *x) {
+    select_t *sel = &selects[x->id];
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        sel->call_since[a] = 0;
+        sel->queued[a] = 0;
+    }
+}
+
+// State preserved across a warm restart
+const void *select_preserved(uint16_t *len) {
+    *len = sizeof(selects);
+    return selects;
+}
+
+void select_set_mode(intersection_t *x, enum SELECT_MODE mode) {
+    selects[x->id].mode = mode;
+}
+
+enum SELECT_MODE select_get_mode(intersection_t *x) {
+    return selects[x->id].mode;
+}
+
+// A vehicle has placed (or added to) a call on a red approach
+void select_call_edge(intersection_t *x, uint8_t approach, uint32_t now) {
+    select_t *sel = &selects[x->id];
+
+    if (approach >= NUM_APPROACHES) return;
+
+    // Keep 0 free to mean "no call"
+    if (!sel->call_since[approach]) {
+        sel->call_since[approach] = now ? now : 1;
+    }
+    if (sel->queued[approach] < 0xFF) {
+        sel->queued[approach]++;
+    }
+}
+
+// A phase has gone green, the calls on the approaches it runs are served
+void select_phase_served(intersection_t *x, enum STATE phase, uint8_t approaches, uint32_t now) {
+    select_t *sel = &selects[x->id];
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        if ((approaches & APPROACH_BIT(a)) && sel->call_since[a]) {
+            uint32_t wait_ds = (now - sel->call_since[a]) / 100;
+            if (wait_ds > sel->max_wait_ds[phase]) {
+                sel->max_wait_ds[phase] = (wait_ds > 0xFFFF) ? 0xFFFF : wait_ds;
+            }
+            sel->call_since[a] = 0;
+            sel->queued[a] = 0;
+        }
+    }
+}
+
+// Approach bits that have waited past the limit (none in fixed order)
+uint8_t select_overdue(intersection_t *x, uint32_t now) {
+    select_t *sel = &selects[x->id];
+    uint8_t overdue = 0;
+    if (sel->mode == SELECT_FIXED) {
+        return 0;
+    }
+    uint32_t max_wait_ms = (uint32_t)config_get()->max_wait_s * 1000;
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        if (sel->call_since[a] && (now - sel->call_since[a]) >= max_wait_ms) {
+            overdue |= APPROACH_BIT(a);
+        }
+    }
+    return overdue;
+}
+
+// Waiting demand on a set of called approaches
+static uint32_t pressure(select_t *sel, uint8_t calls, uint32_t now) {
+    uint32_t score = 0;
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        if ((calls & APPROACH_BIT(a)) && sel->call_since[a]) {
+            score += (now - sel->call_since[a]) / 100;
+            score += (uint32_t)sel->queued[a] * SELECT_VEHICLE_DS;
+        }
+    }
+    return score;
+}
+
+// Next phase to serve, given the sensor bits waiting to be served
+enum STATE select_next_phase(intersection_t *x, enum STATE current, uint8_t pending, uint32_t now) {
+    select_t *sel = &selects[x->id];
+    enum STATE next = current;
+    enum STATE rest = current;
+    uint8_t overdue = select_overdue(x, now);
+    uint8_t best_late = 0;
+    uint32_t best = 0;
+    enum ON found = FALSE;
+
+    for (uint8_t p = Default; p < NUM_STATES; p++) {
+        phase_def_t def;
+        get_phase(p, &def);
+        if (def.flags & PHASE_REST) {
+            rest = p;
+        }
+
+        uint8_t calls = def.calls & pending;
+        if (p == current || !calls) {
+            continue;
+        }
+
+        uint8_t late = (calls & overdue) ? 1 : 0;
+        uint32_t score = (sel->mode == SELECT_FIXED) ? def.priority : pressure(sel, calls, now);
+
+        if (!found || late > best_late || (late == best_late && score > best)) {
+            found = TRUE;
+            best_late = late;
+            best = score;
+            next = p;
+        }
+    }
+
+    // No demands, return to the rest phase
+    return found ? next : rest;
+}
+
+// Longest call-to-green wait seen by a phase, in 0.1 s
+uint16_t select_max_wait_ds(intersection_t *x, enum STATE phase) {
+    if (phase >= NUM_STATES) {
+        return 0;
+    }
+    return selects[x->id].max_wait_ds[phase];
+}
+
+// Write the waits to the host, one step per intersection
+enum ON select_dump(uint16_t step) {
+    if (step == 0) {
+        host_puts_P(dump_header);
+        return TRUE;
+    }
+    uint8_t i = step - 1;
+    const select_t *sel = &selects[i];
+
+    host_putc('x');
+    host_put_number(i);
+    host_puts_P((sel->mode == SELECT_FIXED) ? dump_fixed : dump_pressure);
+    for (uint8_t p = 0; p < NUM_STATES; p++) {
+        host_putc(' ');
+        host_put_number(sel->max_wait_ds[p]);
+    }
+    host_puts_P(dump_eol);
+    return (i + 1 < NUM_INTERSECTIONS) ? TRUE : FALSE;
+}
@@ -0,0 +1,44 @@
+/*
+ * File:   phase_select.h
+ * Author: Traffic Light Controller
+ * 
+ * Choice of the next phase to serve
+ */
+
+#ifndef PHASE_SELECT_H
+#define PHASE_SELECT_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Phase selection policies
+enum SELECT_MODE {
+    SELECT_FIXED,       // Highest phase_table priority first
+    SELECT_PRESSURE,    // Most waiting demand first, bounded by the max wait
+    NUM_SELECT_MODES
+};
+
+#define SELECT_DEFAULT_MODE     SELECT_FIXED
+
+// Default of the configuration's max_wait_s: the longest a called approach
+// may wait under SELECT_PRESSURE before it is served ahead of all others
+// and the running green is forced off (once its min_periods are up)
+#define SELECT_MAX_WAIT_S       60
+
+// Score of one queued vehicle, in 0.1 s of waiting time
+#define SELECT_VEHICLE_DS       50
+
+// Function prototypes
+void select_init(intersection_t *x);
+void select_reset(intersection_t *x);
+const void *select_preserved(uint16_t *len);
+void select_set_mode(intersection_t *x, enum SELECT_MODE mode);
+enum SELECT_MODE select_get_mode(intersection_t *x);
+void select_call_edge(intersection_t *x, uint8_t approach, uint32_t now);
+void select_phase_served(intersection_t *x, enum STATE phase, uint8_t approaches, uint32_t now);
+uint8_t select_overdue(intersection_t *x, uint32_t now);
+enum STATE select_next_phase(intersection_t *x, enum STATE current, uint8_t pending, uint32_t now);
+uint16_t select_max_wait_ds(intersection_t *x, enum STATE phase);
+enum ON select_dump(uint16_t step);
+
+#endif /* PHASE_SELECT_H */
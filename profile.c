@@ -0,0 +1,202 @@
+/*
+ * File:   profile.c
+ * Author: Traffic Light Controller
+ * 
+ * Execution time profiler.
+ *
+ * Timer1 free-runs at the CPU clock, so a region is timed to the cycle.
+ * PROFILE_BEGIN() stamps TCNT1 and the low byte of clock_count, inline,
+ * in a handful of instructions, into the region's slot. PROFILE_END()
+ * stamps them again the same way and marks the run ended. profile_poll(),
+ * from the main loop, works out the time of each ended run and adds it to
+ * the region's figures, so an interrupt pays only for the stamps. A region
+ * that runs again before the poll has only its last run recorded.
+ *
+ * TCNT1 wraps every 4.1 ms; the millisecond count says how many times it
+ * wrapped, as it is within 2 ms of the true time and a wrap is 4.1 ms, so
+ * regions up to 255 ms are timed exactly. The cost of the probes
+ * themselves is measured at setup and taken off.
+ *
+ * Timer1 is the buzzer timer, the buzzer is not used while profiling.
+ */
+
+#include <xc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+#include "host.h"
+#include "profile.h"
+
+// Region labels, indexed by enum PROFILE_REGION
+#define PROFILE_LABEL(name, label) \
+    _Static_assert(sizeof(label) <= 7, #name " label is too long"); \
+    static const char label_##name[] PROGMEM = label;
+PROFILE_REGIONS(PROFILE_LABEL)
+#undef PROFILE_LABEL
+
+#define PROFILE_LABEL_PTR(name, label) label_##name,
+static const char *const labels[NUM_PROFILE_REGIONS] PROGMEM = {
+    PROFILE_REGIONS(PROFILE_LABEL_PTR)
+};
+#undef PROFILE_LABEL_PTR
+
+static const char dump_header[] PROGMEM = "region count min mean max (cycles)\r\n";
+static const char dump_off[] PROGMEM = "profiling off\r\n";
+static const char dump_eol[] PROGMEM = "\r\n";
+
+const char* profile_label_P(enum PROFILE_REGION r) {
+    return (const char*)pgm_read_ptr(&labels[r]);
+}
+
+#if PROFILE
+
+// The extra slot times an empty region, for the probe overhead
+profile_run_t profile_runs[NUM_PROFILE_REGIONS + 1];
+static profile_t profiles[NUM_PROFILE_REGIONS + 1];
+static uint16_t overhead = 0;
+
+// Cycles from a start stamp to an end stamp
+static uint32_t elapsed(const profile_stamp_t *start, uint16_t cycles, uint8_t ms) {
+    uint16_t low = cycles - start->cycles;              // Exact, modulo 65536
+    uint32_t estimate = (uint8_t)(ms - start->ms) * PROFILE_CYCLES_PER_MS;
+    uint32_t c = (estimate & 0xFFFF0000UL) | low;
+
+    // Take the wrap count that lands nearest the millisecond estimate
+    if (c + 0x8000 < estimate) {
+        c += 0x10000;
+    } else if (c > estimate + 0x8000 && c >= 0x10000) {
+        c -= 0x10000;
+    }
+    return c;
+}
+
+static void record(profile_t *p, uint32_t c) {
+    if (!p->count || c < p->min) {
+        p->min = c;
+    }
+    if (c > p->max) {
+        p->max = c;
+    }
+    if (p->count < 0xFFFFFFFFUL) {
+        p->count++;
+    }
+
+    // Halve the running sum before it overflows, the mean is unchanged
+    if (p->total + c < p->total) {
+        p->total /= 2;
+        p->samples /= 2;
+    }
+    p->total += c;
+    p->samples++;
+}
+
+// Record the runs that have ended since the last poll, every main loop pass
+void profile_poll(void) {
+    for (uint8_t r = 0; r <= NUM_PROFILE_REGIONS; r++) {
+        char cSREG = SREG;
+        cli();
+        profile_run_t run = profile_runs[r];
+        profile_runs[r].ended = 0;
+        SREG = cSREG;
+
+        if (run.ended) {
+            uint32_t c = elapsed(&run.start, run.end.cycles, run.end.ms);
+            record(&profiles[r], (c > overhead) ? c - overhead : 0);
+        }
+    }
+}
+
+void setup_profile(void) {
+    TCCR1B = 0;             // Stop to configure
+    TCCR1A = 0;             // Normal mode, no outputs
+    TCCR1C = 0;
+    TIMSK1 = 0;
+    TCNT1 = 0;
+    TCCR1B = _BV(CS10);     // CPU clock, free running
+
+    // The shortest of a few empty regions is the cost of the probes
+    overhead = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        profile_begin(NUM_PROFILE_REGIONS);
+        profile_end(NUM_PROFILE_REGIONS);
+        profile_poll();
+    }
+    overhead = profiles[NUM_PROFILE_REGIONS].min;
+    profile_reset();
+}
+
+void profile_reset(void) {
+    for (uint8_t r = 0; r <= NUM_PROFILE_REGIONS; r++) {
+        char cSREG = SREG;
+        cli();
+        profiles[r].count = 0;
+        profiles[r].min = 0;
+        profiles[r].max = 0;
+        profiles[r].total = 0;
+        profiles[r].samples = 0;
+        SREG = cSREG;
+    }
+}
+
+// Copy of a region's times, FALSE if it hasn't run
+enum ON profile_get(enum PROFILE_REGION r, profile_t *out) {
+    if (r >= NUM_PROFILE_REGIONS) {
+        return FALSE;
+    }
+    char cSREG = SREG;
+    cli();
+    *out = profiles[r];
+    SREG = cSREG;
+    return out->count ? TRUE : FALSE;
+}
+
+#else
+
+void setup_profile(void) {
+}
+
+void profile_poll(void) {
+}
+
+void profile_reset(void) {
+}
+
+enum ON profile_get(enum PROFILE_REGION r, profile_t *out) {
+    return FALSE;
+}
+
+#endif
+
+uint32_t profile_mean(const profile_t *p) {
+    return p->samples ? p->total / p->samples : 0;
+}
+
+// Write the table to the host, a step is the header or one region's line
+enum ON profile_dump(uint16_t step) {
+    profile_t p;
+
+    if (!PROFILE) {
+        host_puts_P(dump_off);
+        return FALSE;
+    }
+    if (step == 0) {
+        host_puts_P(dump_header);
+        return TRUE;
+    }
+    uint8_t r = step - 1;
+    profile_get(r, &p);
+    host_puts_P(profile_label_P(r));
+    host_putc(' ');
+    host_put_number(p.count);
+    host_putc(' ');
+    host_put_number(p.min);
+    host_putc(' ');
+    host_put_number(profile_mean(&p));
+    host_putc(' ');
+    host_put_number(p.max);
+    host_puts_P(dump_eol);
+    return (r + 1 < NUM_PROFILE_REGIONS) ? TRUE : FALSE;
+}
@@ -0,0 +1,108 @@
+/*
+ * File:   profile.h
+ * Author: Traffic Light Controller
+ * 
+ * Execution time profiler, on Timer1 at the CPU clock
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <xc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+
+// Build with -DPROFILE=1 to profile, the probes compile to nothing otherwise
+#ifndef PROFILE
+#define PROFILE 0
+#endif
+
+#define PROFILE_CYCLES_PER_MS   16000UL
+
+// Profiled regions and interrupts
+// X(name, label), label at most 6 characters
+#define PROFILE_REGIONS(X) \
+    X(PROF_SCAN,     "scan") \
+    X(PROF_STATE,    "state") \
+    X(PROF_FRAME,    "frame") \
+    X(PROF_LCD,      "lcd") \
+    X(PROF_ISR_FRAME, "i.frm") \
+    X(PROF_ISR_HAZARD, "i.hzd")
+
+#define PROFILE_ID(name, label) name,
+enum PROFILE_REGION {
+    PROFILE_REGIONS(PROFILE_ID)
+    NUM_PROFILE_REGIONS
+};
+#undef PROFILE_ID
+
+// Execution times of one region, in CPU cycles, probe overhead taken off
+typedef struct {
+    uint32_t count;         // Runs recorded
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;         // Sum of the last samples runs, for the mean
+    uint32_t samples;
+} profile_t;
+
+// Time stamp
+typedef struct {
+    uint16_t cycles;        // TCNT1
+    uint8_t ms;             // Low byte of clock_count
+} profile_stamp_t;
+
+// Last run of a region, not yet recorded if ended is set
+typedef struct {
+    profile_stamp_t start;
+    profile_stamp_t end;
+    uint8_t ended;
+} profile_run_t;
+
+#if PROFILE
+
+extern profile_run_t profile_runs[NUM_PROFILE_REGIONS + 1];
+
+// Start a region: a few instructions, inline, with a constant region.
+// A run that ended but wasn't recorded yet is overwritten.
+static inline void profile_begin(enum PROFILE_REGION r) {
+    char cSREG = SREG;
+    cli();
+    profile_runs[r].ended = 0;
+    profile_runs[r].start.cycles = TCNT1;
+    profile_runs[r].start.ms = *(volatile uint8_t *)&clock_count;
+    SREG = cSREG;
+}
+
+// End a region the same way, profile_poll() records it later
+static inline void profile_end(enum PROFILE_REGION r) {
+    char cSREG = SREG;
+    cli();
+    profile_runs[r].end.cycles = TCNT1;
+    profile_runs[r].end.ms = *(volatile uint8_t *)&clock_count;
+    profile_runs[r].ended = 1;
+    SREG = cSREG;
+}
+
+#define PROFILE_BEGIN(r)    profile_begin(r)
+#define PROFILE_END(r)      profile_end(r)
+
+#else
+
+#define PROFILE_BEGIN(r)
+#define PROFILE_END(r)
+
+#endif
+
+// Function prototypes
+void setup_profile(void);
+void profile_poll(void);
+enum ON profile_get(enum PROFILE_REGION r, profile_t *out);
+uint32_t profile_mean(const profile_t *p);
+const char* profile_label_P(enum PROFILE_REGION r);
+void profile_reset(void);
+enum ON profile_dump(uint16_t step);
+
+#endif /* PROFILE_H */
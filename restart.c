@@ -0,0 +1,131 @@
+/*
+ * File:   restart.c
+ * Author: Traffic Light Controller
+ * 
+ * Warm restart and watchdog supervision.
+ *
+ * The intersection contexts (intersection.c), the time of day clock and
+ * plans in force (tod.c), the phase selection calls (phase_select.c), the
+ * transit priority state (tsp.c), the traffic statistics (stats.c) and
+ * the split optimiser's learned flows (adaptive.c) live in .noinit, which
+ * the C startup leaves alone, and restart_save() keeps a CRC of them and
+ * of the clock alongside. After a watchdog or brown-out reset with a good
+ * CRC the controller carries on from the saved state: the clock is put
+ * back where it was saved, so every phase timer just sees the reset as a
+ * short stall, and the current phase resumes instead of a cold start into
+ * hazard. Anything else (power on, the reset button, a bad CRC) is a cold
+ * start. An interrupt changing the state while it is being saved just
+ * fails the CRC, which falls back to a cold start.
+ *
+ * The watchdog is only fed once every main loop task has checked in since
+ * the last feed, so a hung I2C transfer or a stopped frame interrupt
+ * resets the controller, and it restarts warm.
+ */
+
+#include <xc.h>
+#include <avr/io.h>
+#include <avr/wdt.h>
+#include <util/crc16.h>
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+#include "intersection.h"
+#include "tod.h"
+#include "phase_select.h"
+#include "tsp.h"
+#include "stats.h"
+#include "adaptive.h"
+#include "restart.h"
+
+// Preserved blocks besides the intersections, each module's accessor
+#define RESTART_BLOCKS(X) \
+    X(tod_preserved) \
+    X(select_preserved) \
+    X(tsp_preserved) \
+    X(stats_preserved) \
+    X(adaptive_preserved)
+
+// Preserved across resets, only trusted if the CRC matches
+static uint32_t saved_clock __attribute__((section(".noinit")));
+static uint16_t saved_crc __attribute__((section(".noinit")));
+
+static uint8_t reset_cause __attribute__((section(".noinit")));     // MCUSR at reset
+static uint8_t checked_in = 0;
+
+// Runs before the C startup: a watchdog reset leaves the watchdog running
+// at its shortest period, so it has to be stopped before anything else
+void restart_early(void) __attribute__((naked, used, section(".init3")));
+void restart_early(void) {
+    reset_cause = MCUSR;
+    MCUSR = 0;
+    wdt_disable();
+}
+
+static uint16_t crc_block(uint16_t crc, const void *block, uint16_t len) {
+    const uint8_t *p = block;
+
+    for (uint16_t i = 0; i < len; i++) {
+        crc = _crc_ccitt_update(crc, p[i]);
+    }
+    return crc;
+}
+
+static uint16_t state_crc(uint32_t clock) {
+    uint16_t crc = crc_block(0xFFFF, intersections, sizeof(intersections));
+    const void *block;
+    uint16_t len;
+
+#define RESTART_BLOCK_CRC(preserved) \
+    block = preserved(&len); \
+    crc = crc_block(crc, block, len);
+    RESTART_BLOCKS(RESTART_BLOCK_CRC)
+#undef RESTART_BLOCK_CRC
+
+    for (uint8_t i = 0; i < 4; i++) {
+        crc = _crc_ccitt_update(crc, clock >> (8 * i));
+    }
+    return crc;
+}
+
+// TRUE if the saved state can be resumed, the clock is restored if so
+enum ON restart_warm(void) {
+    if (reset_cause & _BV(PORF)) {
+        return FALSE;
+    }
+    if (!(reset_cause & (_BV(WDRF) | _BV(BORF)))) {
+        return FALSE;
+    }
+    if (state_crc(saved_clock) != saved_crc) {
+        return FALSE;
+    }
+    clock_count = saved_clock;
+    return TRUE;
+}
+
+// MCUSR flags of the last reset
+uint8_t restart_reset_cause(void) {
+    return reset_cause;
+}
+
+// Record the state after it has changed, called from the main loop
+void restart_save(void) {
+    uint32_t now = millis();
+    uint16_t crc = state_crc(now);
+
+    saved_clock = now;
+    saved_crc = crc;
+}
+
+void restart_watchdog_start(void) {
+    checked_in = 0;
+    wdt_enable(RESTART_WDTO);
+}
+
+// A main loop task has run, feed the watchdog once they all have
+void restart_checkin(uint8_t task) {
+    checked_in |= task;
+    if (checked_in == RESTART_TASKS_ALL) {
+        wdt_reset();
+        checked_in = 0;
+    }
+}
@@ -0,0 +1,32 @@
+/*
+ * File:   restart.h
+ * Author: Traffic Light Controller
+ * 
+ * Warm restart from preserved state, and watchdog supervision
+ */
+
+#ifndef RESTART_H
+#define RESTART_H
+
+#include <stdint.h>
+#include <avr/wdt.h>
+#include "Sensors.h"
+
+// Watchdog period, longer than the slowest task (the 200 ms LCD update)
+#define RESTART_WDTO        WDTO_500MS
+
+// Main loop tasks that have to check in before the watchdog is fed
+#define RESTART_TASK_SCAN   0x01    // Sensor scan, hazard switch and host
+#define RESTART_TASK_STATE  0x02    // State machine
+#define RESTART_TASK_FRAME  0x04    // Frame published and the interrupt driving it
+#define RESTART_TASK_LCD    0x08    // LCD update
+#define RESTART_TASKS_ALL   0x0F
+
+// Function prototypes
+enum ON restart_warm(void);
+uint8_t restart_reset_cause(void);
+void restart_save(void);
+void restart_watchdog_start(void);
+void restart_checkin(uint8_t task);
+
+#endif /* RESTART_H */
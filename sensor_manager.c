@@ -8,126 +8,67 @@
 #include <xc.h>
 #include <stdint.h>
 #include "Sensors.h"
-#include "SPI.h"
 #include "abs_clock.h"
 #include "sensor_manager.h"
-
-// Sensor debounce time in milliseconds
-#define DEBOUNCE_TIME_MS 50
-
-// Sensor state tracking
-sensor_state_t sensors = {0, 0, 0, 0};
-
-// Debounce tracking
-
-typedef struct {
-    uint8_t state;
-    uint32_t last_change;
-} debounce_t;
-
-static debounce_t sensor_debounce[6] = {
-    {0, 0},
-    {0, 0},
-    {0, 0},
-    {0, 0},
-    {0, 0},
-    {0, 0}
-};
-
-// Check if a sensor is currently pressed (with debouncing)
-
-static uint8_t is_sensor_pressed(uint8_t sensor_num) {
-    uint8_t current_state = 0;
-
-    switch (sensor_num) {
-        case 0: // S0 - Dam Street (Port A, bit 0)
-            current_state = !(SPI_Read_Command(0x12) & S0);
-            break;
-        case 1: // S1 - Park Road West (Port A, bit 4)
-            current_state = !(SPI_Read_Command(0x12) & S1);
-            break;
-        case 2: // S2 - Park Road West Turn (Port B, bit 0)
-            current_state = !(SPI_Read_Command(0x13) & S2);
-            break;
-        case 3: // S3 - Park Road East (Port B, bit 4)
-            current_state = !(SPI_Read_Command(0x13) & S3);
-            break;
-        case 4: // S4 - Railway Street (PB0)
-            current_state = !(PINB & (1 << 0));
-            break;
-        case 5: // S5 - Bus sensor (PD6) - for extension
-            current_state = !(PIND & (1 << 6));
-            break;
-    }
-
-    return current_state;
-}
+#include "intersection.h"
+#include "phase_select.h"
+#include "stats.h"
+#include "tsp.h"
+#include "config.h"
+#include "eventlog.h"
 
 // Update sensor states with debouncing
 
-void update_sensor_states(void) {
+void update_sensor_states(intersection_t *x) {
     uint32_t now = millis();
+    uint8_t pressed = intersection_read_sensors(x);
+    uint8_t debounce_ms = config_get()->debounce_ms;
 
-    for (uint8_t i = 0; i < 6; i++) {
-        uint8_t current = is_sensor_pressed(i);
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        uint8_t current = (pressed & (1 << i)) ? 1 : 0;
 
         // Check if state has changed
-        if (current != sensor_debounce[i].state) {
+        if (current != x->debounce[i].state) {
             // State changed, check if debounce time has passed
-            if ((now - sensor_debounce[i].last_change) >= DEBOUNCE_TIME_MS) {
-                sensor_debounce[i].state = current;
-                sensor_debounce[i].last_change = now;
+            if ((now - x->debounce[i].last_change) >= debounce_ms) {
+                x->debounce[i].state = current;
+                x->debounce[i].last_change = now;
+                stats_sensor_edge(x, i, current, now);
+                eventlog_add(current ? EVENT_SENSOR_ON : EVENT_SENSOR_OFF, EVENT_ARG(x->id, i));
+                if (i == TSP_SENSOR) {
+                    tsp_sensor_edge(x, current, now);
+                }
                 if (current) {
 
-                    switch (i) {
-                        case 0: // Dam Street
-                            DMS.on = TRUE;
-                            break;
-                        case 1: // Park Road West
-                            PRWS.on = TRUE;
-                            break;
-                        case 2: // Park Road West Turn
-                            PRWT.on = TRUE;
-                            break;
-                        case 3: // Park Road East
-                            PRES.on = TRUE;
-                            break;
-                        case 4: // Railway Street
-                            RWS.on = TRUE;
-                            break;
+                    if (i < NUM_APPROACHES) {
+                        x->light_demand |= APPROACH_BIT(i);
+                        x->light_actuated |= APPROACH_BIT(i);
                     }
 
-
-                    // Update triggered state on rising edge
-                    if (!(sensors.handled & (1 << i))) {
-                        sensors.triggered |= (1 << i);
+                    // A new vehicle places a new call, unless its light is
+                    // already green and it is being served
+                    if (i >= NUM_APPROACHES || GET_COLOUR(x, i) != GREEN) {
+                        x->sensors.handled &= ~(1 << i);
+                        x->sensors.triggered |= (1 << i);
+                        select_call_edge(x, i, now);
                     }
                 }
             }
 
         } else {
             // State stable, reset debounce timer
-            sensor_debounce[i].last_change = now;
+            x->debounce[i].last_change = now;
 
             // Keep triggered state active while button is held
 
 
             // Clear states when button is released
             if (!current) {
-                switch (i) {
-                    case 0: DMS.on = FALSE;
-                        break;
-                    case 1: PRWS.on = FALSE;
-                        break;
-                    case 2: PRWT.on = FALSE;
-                        break;
-                    case 3: PRES.on = FALSE;
-                        break;
-                    case 4: RWS.on = FALSE;
-                        break;
+                if (i < NUM_APPROACHES) {
+                    x->light_demand &= ~APPROACH_BIT(i);
                 }
-                if (!sensor_needs_handling(i)) {
-                    sensors.triggered &= ~(1 << i);
+                if (!sensor_needs_handling(x, i)) {
+                    x->sensors.triggered &= ~(1 << i);
                 }
             }
         }
@@ -135,56 +76,47 @@ void update_sensor_states(void) {
 }
     // Mark a sensor as handled
 
-    void mark_sensor_handled(uint8_t sensor_num) {
-        if (sensor_num < 6) {
-            sensors.handled |= (1 << sensor_num);
+    void mark_sensor_handled(intersection_t *x, uint8_t sensor_num) {
+        if (sensor_num < NUM_SENSORS) {
+            x->sensors.handled |= (1 << sensor_num);
 
             // Clear triggered state once handled
-            if (!(sensor_debounce[sensor_num].state)) {
-                sensors.triggered &= ~(1 << sensor_num);
+            if (!(x->debounce[sensor_num].state)) {
+                x->sensors.triggered &= ~(1 << sensor_num);
             }
         }
     }
 
     // Check if a sensor needs handling
 
-    uint8_t sensor_needs_handling(uint8_t sensor_num) {
-        if (sensor_num >= 6) return 0;
+    uint8_t sensor_needs_handling(intersection_t *x, uint8_t sensor_num) {
+        if (sensor_num >= NUM_SENSORS) return 0;
 
-        return (sensors.triggered & (1 << sensor_num)) &&
-                !(sensors.handled & (1 << sensor_num));
+        return (x->sensors.triggered & (1 << sensor_num)) &&
+                !(x->sensors.handled & (1 << sensor_num));
     }
 
     // Clear all sensor states
 
-    void clear_all_sensors(void) {
-        sensors.triggered = 0;
-        sensors.handled = 0;
-        sensors.current = 0;
-        sensors.previous = 0;
+    void clear_all_sensors(intersection_t *x) {
+        x->sensors.triggered = 0;
+        x->sensors.handled = 0;
+        x->sensors.current = 0;
+        x->sensors.previous = 0;
     }
 
 
 
     // Mark sensors as handled when their phase starts
 
-    void mark_phase_sensors_handled(enum STATE phase) {
-        switch (phase) {
-            case Default:
-                mark_sensor_handled(1); // S1 - Park Road West
-                mark_sensor_handled(3); // S3 - Park Road East
-                break;
-            case ParkRdWestTurn:
-                mark_sensor_handled(2); // S2 - Park Road West Turn
-                break;
-            case RailwayStThrough:
-                mark_sensor_handled(4); // S4 - Railway Street
-                break;
-            case DamStThrough:
-                mark_sensor_handled(0); // S0 - Dam Street
-                break;
-            case Hazard:
-                // Don't clear sensors in hazard mode
-                break;
+    void mark_phase_sensors_handled(intersection_t *x, enum STATE phase) {
+        // Sensors served by the phase come from the phase table
+        // (none for Hazard, so sensors aren't cleared in hazard mode)
+        uint8_t serves = pgm_read_byte(&phase_table[phase].serves);
+
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            if (serves & (1 << i)) {
+                mark_sensor_handled(x, i);
+            }
         }
     }
\ No newline at end of file
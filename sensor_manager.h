@@ -11,6 +11,9 @@
 #include <stdint.h>
 #include "Sensors.h"
 
+// Default sensor debounce time in milliseconds (config.c)
+#define DEBOUNCE_TIME_MS 50
+
 // Sensor state structure
 typedef struct {
     uint8_t current;
@@ -19,14 +22,17 @@ typedef struct {
     uint8_t handled;
 } sensor_state_t;
 
-// External sensor state
-extern sensor_state_t sensors;
+// Debounce tracking
+typedef struct {
+    uint8_t state;
+    uint32_t last_change;
+} debounce_t;
 
 // Function prototypes
-void update_sensor_states(void);
-void mark_sensor_handled(uint8_t sensor_num);
-uint8_t sensor_needs_handling(uint8_t sensor_num);
-void clear_all_sensors(void);
-void mark_phase_sensors_handled(enum STATE phase);
+void update_sensor_states(intersection_t *x);
+void mark_sensor_handled(intersection_t *x, uint8_t sensor_num);
+uint8_t sensor_needs_handling(intersection_t *x, uint8_t sensor_num);
+void clear_all_sensors(intersection_t *x);
+void mark_phase_sensors_handled(intersection_t *x, enum STATE phase);
 
 #endif /* SENSOR_MANAGER_H */
\ No newline at end of file
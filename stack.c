@@ -0,0 +1,68 @@
+/*
+ * File:   stack.c
+ * Author: Traffic Light Controller
+ * 
+ * Stack high-water mark and RAM usage.
+ *
+ * Everything between the end of the static data (.data, .bss and .noinit)
+ * and the top of RAM is painted with STACK_CANARY before main() runs. The
+ * stack grows down into it, so the lowest byte that no longer holds the
+ * canary is the deepest the stack has been, interrupts included.
+ *
+ * stack_scan() is called from the main loop and checks STACK_SCAN_BYTES
+ * per call, working up from the end of the static data. A pass ends at
+ * the lowest disturbed byte found so far, or a new lower one, and the next
+ * pass starts again from the bottom.
+ */
+
+#include <xc.h>
+#include <avr/io.h>
+#include <stdint.h>
+#include "stack.h"
+
+extern uint8_t _end;            // End of static data, from the linker
+
+static uint8_t *deepest = (uint8_t *)RAMEND + 1;    // Lowest byte disturbed
+static uint8_t *scan = &_end;                       // Next byte to check
+
+// Paint the free RAM. The stack is still empty in .init3 and nothing has
+// been called, so all of it can go.
+void stack_paint(void) __attribute__((naked, used, section(".init3")));
+void stack_paint(void) {
+    uint8_t *p = &_end;
+
+    while (p <= (uint8_t *)RAMEND) {
+        *p++ = STACK_CANARY;
+    }
+}
+
+// Check the next few bytes, called from the main loop
+void stack_scan(void) {
+    for (uint8_t i = 0; i < STACK_SCAN_BYTES; i++) {
+        if (scan >= deepest) {
+            scan = &_end;
+            return;
+        }
+        if (*scan != STACK_CANARY) {
+            deepest = scan;
+            scan = &_end;
+            return;
+        }
+        scan++;
+    }
+}
+
+// Most stack used so far, in bytes
+uint16_t stack_peak(void) {
+    return (uint8_t *)RAMEND + 1 - deepest;
+}
+
+// RAM the stack has never reached
+uint16_t stack_free(void) {
+    return deepest - &_end;
+}
+
+// RAM taken by static data
+uint16_t stack_static(void) {
+    return &_end - (uint8_t *)RAMSTART;
+}
@@ -0,0 +1,25 @@
+/*
+ * File:   stack.h
+ * Author: Traffic Light Controller
+ * 
+ * Stack high-water mark and RAM usage
+ */
+
+#ifndef STACK_H
+#define STACK_H
+
+#include <stdint.h>
+
+// Written over free RAM at reset, the stack overwrites it as it grows
+#define STACK_CANARY        0xC5
+
+// Bytes checked per stack_scan() call
+#define STACK_SCAN_BYTES    16
+
+// Function prototypes
+void stack_scan(void);
+uint16_t stack_peak(void);
+uint16_t stack_free(void);
+uint16_t stack_static(void);
+
+#endif /* STACK_H */
@@ -0,0 +1,234 @@
+/*
+ * File:   stats.c
+ * Author: Traffic Light Controller
+ *
+ * Per-approach vehicle counts, occupancy, green time and time to service.
+ *
+ * Detector edges come in from update_sensor_states(), the light colours
+ * are sampled by stats_update() on every state machine tick. Everything is
+ * kept in four fixed bins per approach: the minute being filled, the last
+ * complete minute, the quarter hour being filled and the last complete
+ * quarter hour. The quarter hour is built up by folding each finished
+ * minute into it, so the RAM cost is fixed at 4 bins per approach.
+ * A detector still occupied when a minute closes has the time so far put
+ * in that minute, the rest goes in the minutes after.
+ *
+ * The split optimiser (adaptive.c) reads the last minute, and the V host
+ * command dumps the last minute and last quarter of every approach.
+ */
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "Sensors.h"
+#include "intersection.h"
+#include "host.h"
+#include "stats.h"
+
+// Statistics of one intersection
+typedef struct {
+    stats_bin_t bins[NUM_APPROACHES][STATS_NUM_BINS];
+
+    uint32_t occupied_since[NUM_APPROACHES];    // 0 = detector clear
+    uint32_t call_since[NUM_APPROACHES];        // 0 = no call waiting
+    uint16_t green_ms[NUM_APPROACHES];          // Green time not yet in a bin
+    uint8_t was_green;                          // Approach bits green last tick
+
+    uint32_t minute_start;
+    uint32_t last_update;
+    uint8_t quarter_minutes;
+    uint16_t minutes;                           // Completed minutes, wraps
+} stats_t;
+
+// Kept across a warm restart (restart.c)
+static stats_t stats[NUM_INTERSECTIONS] __attribute__((section(".noinit")));
+
+static const char dump_header[] PROGMEM = "id approach m/q count occupancy_ds green_ds wait_ds served\r\n";
+static const char dump_eol[] PROGMEM = "\r\n";
+
+// Bins in the dump, in order
+static const uint8_t dump_bins[] PROGMEM = {STATS_LAST_MINUTE, STATS_LAST_QUARTER};
+static const char dump_bin_names[] PROGMEM = "mq";
+#define DUMP_BINS   ((uint8_t)sizeof(dump_bins))
+
+// Add to a 16 bit counter without wrapping
+static void add_sat(uint16_t *acc, uint32_t value) {
+    uint32_t sum = *acc + value;
+    *acc = (sum > 0xFFFF) ? 0xFFFF : sum;
+}
+
+// Fold a finished bin into a longer one
+static void fold_bin(stats_bin_t *into, const stats_bin_t *from) {
+    add_sat(&into->count, from->count);
+    add_sat(&into->occupancy_ds, from->occupancy_ds);
+    add_sat(&into->green_ds, from->green_ds);
+    add_sat(&into->wait_ds, from->wait_ds);
+    into->served = (into->served + from->served > 0xFF) ? 0xFF : into->served + from->served;
+}
+
+static void clear_bin(stats_bin_t *bin) {
+    bin->count = 0;
+    bin->occupancy_ds = 0;
+    bin->green_ds = 0;
+    bin->wait_ds = 0;
+    bin->served = 0;
+}
+
+// Close the current minute, ending at minute_start, and every 15 minutes
+// the current quarter
+static void roll_minute(stats_t *st) {
+    st->minutes++;
+    st->quarter_minutes++;
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        stats_bin_t *b = st->bins[a];
+
+        // Occupied across the end of the minute, the part before it counts
+        // now. Whole 0.1 s only, what's left over stays with the vehicle.
+        uint32_t since = st->occupied_since[a];
+        if (since && (int32_t)(st->minute_start - since) > 0) {
+            uint32_t ds = (st->minute_start - since) / 100;
+            add_sat(&b[STATS_THIS_MINUTE].occupancy_ds, ds);
+            st->occupied_since[a] = since + ds * 100;
+        }
+
+        fold_bin(&b[STATS_THIS_QUARTER], &b[STATS_THIS_MINUTE]);
+        b[STATS_LAST_MINUTE] = b[STATS_THIS_MINUTE];
+        clear_bin(&b[STATS_THIS_MINUTE]);
+        if (st->quarter_minutes >= STATS_QUARTER_MINUTES) {
+            b[STATS_LAST_QUARTER] = b[STATS_THIS_QUARTER];
+            clear_bin(&b[STATS_THIS_QUARTER]);
+        }
+    }
+    if (st->quarter_minutes >= STATS_QUARTER_MINUTES) {
+        st->quarter_minutes = 0;
+    }
+}
+
+// Cold start: every bin empty, the first minute starting now
+void stats_init(intersection_t *x, uint32_t now) {
+    stats_t *st = &stats[x->id];
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        for (uint8_t b = 0; b < STATS_NUM_BINS; b++) {
+            clear_bin(&st->bins[a][b]);
+        }
+        st->occupied_since[a] = 0;
+        st->call_since[a] = 0;
+        st->green_ms[a] = 0;
+    }
+    st->was_green = 0;
+    st->minute_start = now;
+    st->last_update = now;
+    st->quarter_minutes = 0;
+    st->minutes = 0;
+}
+
+// State preserved across a warm restart
+const void *stats_preserved(uint16_t *len) {
+    *len = sizeof(stats);
+    return stats;
+}
+
+// Called on every debounced detector edge
+void stats_sensor_edge(intersection_t *x, uint8_t sensor_num, uint8_t pressed, uint32_t now) {
+    stats_t *st = &stats[x->id];
+
+    if (sensor_num >= NUM_APPROACHES) return;
+
+    // Keep 0 free to mean "not running"
+    uint32_t stamp = now ? now : 1;
+    stats_bin_t *bin = &st->bins[sensor_num][STATS_THIS_MINUTE];
+
+    if (pressed) {
+        add_sat(&bin->count, 1);
+        st->occupied_since[sensor_num] = stamp;
+
+        // A vehicle arriving on green is served straight away
+        if (!st->call_since[sensor_num] && GET_COLOUR(x, sensor_num) != GREEN) {
+            st->call_since[sensor_num] = stamp;
+        }
+    } else if (st->occupied_since[sensor_num]) {
+        add_sat(&bin->occupancy_ds, (now - st->occupied_since[sensor_num]) / 100);
+        st->occupied_since[sensor_num] = 0;
+    }
+}
+
+// Sample the lights and roll the bins, called every state machine tick
+void stats_update(intersection_t *x, uint32_t now) {
+    stats_t *st = &stats[x->id];
+    uint16_t elapsed = (now - st->last_update > STATS_MINUTE_MS) ? STATS_MINUTE_MS : now - st->last_update;
+    st->last_update = now;
+
+    for (uint8_t a = 0; a < NUM_APPROACHES; a++) {
+        stats_bin_t *bin = &st->bins[a][STATS_THIS_MINUTE];
+        uint8_t bit = 1 << a;
+
+        if (GET_COLOUR(x, a) == GREEN) {
+            // Time to service ends when the approach turns green
+            if (!(st->was_green & bit) && st->call_since[a]) {
+                add_sat(&bin->wait_ds, (now - st->call_since[a]) / 100);
+                if (bin->served < 0xFF) {
+                    bin->served++;
+                }
+                st->call_since[a] = 0;
+            }
+            st->was_green |= bit;
+
+            st->green_ms[a] += elapsed;
+            if (st->green_ms[a] >= 100) {
+                add_sat(&bin->green_ds, st->green_ms[a] / 100);
+                st->green_ms[a] %= 100;
+            }
+        } else {
+            st->was_green &= ~bit;
+        }
+    }
+
+    if ((now - st->minute_start) >= STATS_MINUTE_MS) {
+        st->minute_start += STATS_MINUTE_MS;
+        roll_minute(st);
+    }
+}
+
+// Read back a bin for an approach (dms, prws, prwt, pres or rws)
+const stats_bin_t* stats_get(intersection_t *x, uint8_t approach, enum STATS_BIN bin) {
+    if (approach >= NUM_APPROACHES || bin >= STATS_NUM_BINS) {
+        return 0;
+    }
+    return &stats[x->id].bins[approach][bin];
+}
+
+// Number of minutes completed, changes each time STATS_LAST_MINUTE is refreshed
+uint16_t stats_minutes(intersection_t *x) {
+    return stats[x->id].minutes;
+}
+// Write the bins to the host, one step per approach and bin
+enum ON stats_dump(uint16_t step) {
+    if (step == 0) {
+        host_puts_P(dump_header);
+        return TRUE;
+    }
+    step--;
+    uint8_t which = step % DUMP_BINS;
+    uint8_t a = (step / DUMP_BINS) % NUM_APPROACHES;
+    uint8_t i = step / (DUMP_BINS * NUM_APPROACHES);
+    const stats_bin_t *bin = &stats[i].bins[a][pgm_read_byte(&dump_bins[which])];
+
+    host_putc('x');
+    host_put_number(i);
+    host_putc(' ');
+    host_put_number(a);
+    host_putc(' ');
+    host_putc(pgm_read_byte(&dump_bin_names[which]));
+    host_putc(' ');
+    host_put_number(bin->count);
+    host_putc(' ');
+    host_put_number(bin->occupancy_ds);
+    host_putc(' ');
+    host_put_number(bin->green_ds);
+    host_putc(' ');
+    host_put_number(bin->wait_ds);
+    host_putc(' ');
+    host_put_number(bin->served);
+    host_puts_P(dump_eol);
+    return (step + 1 < DUMP_BINS * NUM_APPROACHES * NUM_INTERSECTIONS) ? TRUE : FALSE;
+}
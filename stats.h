@@ -0,0 +1,45 @@
+/*
+ * File:   stats.h
+ * Author: Traffic Light Controller
+ *
+ * Per-approach traffic statistics
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Bin lengths
+#define STATS_MINUTE_MS         60000UL
+#define STATS_QUARTER_MINUTES   15
+
+// Which bin to read back
+enum STATS_BIN {
+    STATS_THIS_MINUTE,
+    STATS_LAST_MINUTE,
+    STATS_THIS_QUARTER,
+    STATS_LAST_QUARTER,
+    STATS_NUM_BINS
+};
+
+// One statistics bin for one approach (times in 0.1 s units)
+typedef struct {
+    uint16_t count;         // Vehicle actuations (debounced rising edges)
+    uint16_t occupancy_ds;  // Time the detector was occupied
+    uint16_t green_ds;      // Green time the approach was given
+    uint16_t wait_ds;       // Summed call-to-green time
+    uint8_t served;         // Calls served, to average wait_ds
+} stats_bin_t;
+
+// Function prototypes
+void stats_init(intersection_t *x, uint32_t now);
+const void *stats_preserved(uint16_t *len);
+void stats_sensor_edge(intersection_t *x, uint8_t sensor_num, uint8_t pressed, uint32_t now);
+void stats_update(intersection_t *x, uint32_t now);
+const stats_bin_t* stats_get(intersection_t *x, uint8_t approach, enum STATS_BIN bin);
+uint16_t stats_minutes(intersection_t *x);
+enum ON stats_dump(uint16_t step);
+
+#endif /* STATS_H */
\ No newline at end of file
@@ -0,0 +1,210 @@
+/*
+ * File:   telemetry.c
+ * Author: Traffic Light Controller
+ * 
+ * Binary telemetry frames on the host serial port.
+ *
+ * telemetry_poll() runs every main loop pass and compares each
+ * intersection with what it last sent: a phase change, new light colours,
+ * a detector edge or a new time period each go out as a small frame, and
+ * the performance counters go out every TELEMETRY_PERF_MS and the bus
+ * utilisation every BUS_STATS_ROLL_MS. Frames are
+ * queued with host_send_frame(), which never waits. A frame that doesn't
+ * fit is not marked sent, so it goes out on a later pass with the values
+ * of the time. A change is only lost, and counted once, if another change
+ * replaces it before it goes out; a periodic frame if the next one falls
+ * due first. Waiting for room is not a loss in itself.
+ * tools/telemetry.py decodes the stream.
+ */
+
+#include <stdint.h>
+#include "abs_clock.h"
+#include "Sensors.h"
+#include "intersection.h"
+#include "host.h"
+#include "tod.h"
+#include "stack.h"
+#include "frame.h"
+#include "monitor.h"
+#include "restart.h"
+#include "deadline.h"
+#include "I2C.h"
+#include "SPI.h"
+#include "telemetry.h"
+
+_Static_assert(sizeof(telemetry_perf_t) <= HOST_PAYLOAD_MAX, "performance frame too long");
+_Static_assert(sizeof(telemetry_bus_t) <= HOST_PAYLOAD_MAX, "bus frame too long");
+
+// One value of an intersection: what was last sent, and a change still
+// waiting for room
+typedef struct {
+    uint16_t sent;
+    uint16_t waiting;
+    enum ON pending;
+} track_t;
+
+// Values of one intersection
+typedef struct {
+    track_t state;          // Phase, hazard in the high byte
+    track_t colours;
+    track_t pressed;
+    track_t period_ms;
+} sent_t;
+
+static sent_t sent[NUM_INTERSECTIONS];
+static enum ON enabled = TELEMETRY_DEFAULT_ON;
+static uint32_t last_perf = 0;
+static uint32_t last_bus = 0;
+static uint16_t dropped = 0;            // Changes replaced before they went out
+
+static void count_drop(void) {
+    if (dropped < 0xFFFF) {
+        dropped++;
+    }
+}
+
+static void track_init(track_t *t, uint16_t never) {
+    t->sent = never;
+    t->pending = FALSE;
+}
+
+// TRUE if value has to go out. A waiting change it replaces is lost.
+static enum ON track_changed(track_t *t, uint16_t value) {
+    if (t->pending && value != t->waiting) {
+        count_drop();
+        t->pending = FALSE;
+    }
+    return (value != t->sent) ? TRUE : FALSE;
+}
+
+// Record the outcome of sending value
+static void track_sent(track_t *t, uint16_t value, enum ON ok) {
+    if (ok) {
+        t->sent = value;
+        t->pending = FALSE;
+    } else {
+        t->waiting = value;
+        t->pending = TRUE;
+    }
+}
+
+// Forget what was sent, so everything goes out again
+void telemetry_init(void) {
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        track_init(&sent[i].state, 0xFFFF);
+        track_init(&sent[i].colours, 0xFFFF);
+        track_init(&sent[i].pressed, 0xFFFF);
+        track_init(&sent[i].period_ms, 0);
+    }
+    last_perf = millis() - TELEMETRY_PERF_MS;
+    last_bus = millis() - BUS_STATS_ROLL_MS;
+}
+
+void telemetry_enable(enum ON on) {
+    if (on && !enabled) {
+        telemetry_init();
+    }
+    enabled = on;
+}
+
+static uint8_t pressed_bits(intersection_t *x) {
+    uint8_t bits = 0;
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        if (x->debounce[i].state) {
+            bits |= (1 << i);
+        }
+    }
+    return bits;
+}
+
+static void send_perf(uint32_t now) {
+    telemetry_perf_t f;
+    uint16_t trips = 0;
+
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        trips += monitor_get_log(&intersections[i])->trips;
+    }
+    f.ms = now;
+    f.stack_peak = stack_peak();
+    f.stack_free = stack_free();
+    f.frame_commits = frame_commits();
+    f.monitor_trips = trips;
+    f.dropped = dropped;
+    f.reset_cause = restart_reset_cause();
+    f.plan = tod_plan();
+    for (uint8_t t = 0; t < NUM_DEADLINE_TASKS; t++) {
+        f.worst_late_us[t] = deadline_get(t)->worst_us;
+    }
+    if (host_send_frame(TELEMETRY_PERF, &f, sizeof(f))) {
+        last_perf = now;
+    } else if ((now - last_perf) >= 2 * TELEMETRY_PERF_MS) {
+        count_drop();
+        last_perf += TELEMETRY_PERF_MS;
+    }
+}
+
+static void bus_load(telemetry_bus_load_t *f, const bus_stats_t *b) {
+    f->util_pct = b->util_pct;
+    f->transactions_ps = b->transactions_ps;
+    f->bytes_ps = b->bytes_ps;
+    f->errors = b->errors;
+    f->busy_us = b->busy_us;
+}
+
+static void send_bus(uint32_t now) {
+    telemetry_bus_t f;
+    bus_stats_t b;
+
+    f.ms = now;
+    I2C_Stats(&b);
+    bus_load(&f.i2c, &b);
+    SPI_Stats(&b);
+    bus_load(&f.spi, &b);
+    if (host_send_frame(TELEMETRY_BUS, &f, sizeof(f))) {
+        last_bus = now;
+    } else if ((now - last_bus) >= 2 * BUS_STATS_ROLL_MS) {
+        count_drop();
+        last_bus += BUS_STATS_ROLL_MS;
+    }
+}
+
+// Send what has changed, called every main loop pass
+void telemetry_poll(uint32_t now) {
+    if (!enabled) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        intersection_t *x = &intersections[i];
+        sent_t *s = &sent[i];
+
+        uint16_t state = x->state | ((uint16_t)x->hazard << 8);
+        if (track_changed(&s->state, state)) {
+            telemetry_state_t f = {now, i, x->state, x->hazard};
+            track_sent(&s->state, state, host_send_frame(TELEMETRY_STATE, &f, sizeof(f)));
+        }
+        uint16_t colours = x->light_colours;
+        if (track_changed(&s->colours, colours)) {
+            telemetry_lights_t f = {now, i, colours};
+            track_sent(&s->colours, colours, host_send_frame(TELEMETRY_LIGHTS, &f, sizeof(f)));
+        }
+        uint8_t pressed = pressed_bits(x);
+        if (track_changed(&s->pressed, pressed)) {
+            telemetry_sensors_t f = {now, i, pressed};
+            track_sent(&s->pressed, pressed, host_send_frame(TELEMETRY_SENSORS, &f, sizeof(f)));
+        }
+        uint16_t period_ms = x->period_ms;
+        if (track_changed(&s->period_ms, period_ms)) {
+            telemetry_period_t f = {now, i, period_ms};
+            track_sent(&s->period_ms, period_ms, host_send_frame(TELEMETRY_PERIOD, &f, sizeof(f)));
+        }
+    }
+
+    if ((now - last_perf) >= TELEMETRY_PERF_MS) {
+        send_perf(now);
+    }
+    if ((now - last_bus) >= BUS_STATS_ROLL_MS) {
+        send_bus(now);
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * File:   telemetry.h
+ * Author: Traffic Light Controller
+ * 
+ * Binary telemetry frames on the host serial port
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include "Sensors.h"
+#include "deadline.h"
+#include "bus_stats.h"
+
+// Stream from power up
+#define TELEMETRY_DEFAULT_ON    TRUE
+
+// Performance counters interval
+#define TELEMETRY_PERF_MS       1000
+
+// Frame types, the payloads below, all little endian
+enum TELEMETRY_TYPE {
+    TELEMETRY_STATE = 1,        // Phase change
+    TELEMETRY_LIGHTS,           // Light colours change
+    TELEMETRY_SENSORS,          // Debounced detector edge
+    TELEMETRY_PERIOD,           // Time period change
+    TELEMETRY_PERF,             // Performance counters
+    TELEMETRY_BUS               // I2C and SPI utilisation
+};
+
+typedef struct __attribute__((packed)) {
+    uint32_t ms;
+    uint8_t id;                 // Intersection
+    uint8_t state;              // enum STATE
+    uint8_t hazard;
+} telemetry_state_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t ms;
+    uint8_t id;
+    uint16_t colours;           // 2 bits per approach, enum COLOUR
+} telemetry_lights_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t ms;
+    uint8_t id;
+    uint8_t pressed;            // Sensor bits
+} telemetry_sensors_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t ms;
+    uint8_t id;
+    uint16_t period_ms;
+} telemetry_period_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t ms;
+    uint16_t stack_peak;        // Bytes
+    uint16_t stack_free;
+    uint16_t frame_commits;     // Wraps
+    uint16_t monitor_trips;     // All intersections
+    uint16_t dropped;           // Changes replaced before they went out
+    uint8_t reset_cause;        // MCUSR at the last reset
+    uint8_t plan;               // enum PLAN
+    uint32_t worst_late_us[NUM_DEADLINE_TASKS];
+} telemetry_perf_t;
+
+// One bus, the rates and utilisation are of the last roll
+typedef struct __attribute__((packed)) {
+    uint8_t util_pct;
+    uint16_t transactions_ps;
+    uint16_t bytes_ps;
+    uint16_t errors;            // Since power up, saturates
+    uint32_t busy_us;           // Since power up, wraps
+} telemetry_bus_load_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t ms;
+    telemetry_bus_load_t i2c;
+    telemetry_bus_load_t spi;
+} telemetry_bus_t;
+
+// Function prototypes
+void telemetry_init(void);
+void telemetry_enable(enum ON on);
+void telemetry_poll(uint32_t now);
+
+#endif /* TELEMETRY_H */
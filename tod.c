@@ -0,0 +1,178 @@
+/*
+ * File:   tod.c
+ * Author: Traffic Light Controller
+ * 
+ * Time of day clock and timing plan schedule.
+ *
+ * The clock counts seconds of the day from clock_count, and is set from
+ * the host (host.c). Until it is set the controller runs TOD_DEFAULT_PLAN.
+ * The schedule picks a plan for each part of the day. A new plan is not
+ * switched in all at once: at each cycle boundary (the rest phase turning
+ * green) every min/max moves at most TOD_STEP_PERIODS and the base period
+ * at most TOD_STEP_MS towards it, so queues built under the old split are
+ * not cut off. The clock and schedule are shared, each intersection steps
+ * its own limits at its own cycle boundaries.
+ *
+ * The plans and schedule in force are the configuration's (config.c), the
+ * tables here are only its defaults.
+ */
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "Sensors.h"
+#include "phase_select.h"
+#include "adaptive.h"
+#include "intersection.h"
+#include "tod.h"
+#include "config.h"
+
+// Timing plans, indexed by enum PLAN
+// {mins for PRWS, PRWT, RWS, DMS}, {maxes}, base period, selection
+const timing_plan_t default_plans[NUM_PLANS] PROGMEM = {
+    {{3, 2, 2, 2}, {5, 3, 3, 3}, 1000, SELECT_FIXED},   // Night
+    {{5, 2, 2, 2}, {10, 4, 3, 4}, 1000, SELECT_FIXED},  // AM peak, inbound on Park Road
+    {{4, 2, 2, 2}, {6, 4, 3, 4}, 1000, SELECT_FIXED},   // Midday
+    {{5, 2, 2, 3}, {9, 4, 3, 6}, 1000, SELECT_FIXED},   // PM peak, Dam Street outbound
+};
+
+// Schedule, in start order
+const tod_entry_t default_schedule[TOD_SCHEDULE_LEN] PROGMEM = {
+    {0,       PLAN_NIGHT},
+    {6 * 60 + 30,  PLAN_AM_PEAK},
+    {9 * 60 + 30,  PLAN_MIDDAY},
+    {15 * 60 + 30, PLAN_PM_PEAK},
+    {18 * 60 + 30, PLAN_MIDDAY},
+    {22 * 60,      PLAN_NIGHT},
+    {TOD_UNUSED,   0},
+    {TOD_UNUSED,   0},
+};
+
+// Clock and limits in force, kept across a warm restart (restart.c)
+typedef struct {
+    uint32_t seconds;                   // Seconds of the day
+    uint32_t second_start;              // clock_count at the start of this second
+    enum ON clock_set;
+    enum PLAN target;
+    timing_plan_t running[NUM_INTERSECTIONS];   // Limits in force, stepping to target
+} tod_t;
+
+static tod_t tod __attribute__((section(".noinit")));
+
+// Load a plan straight into force
+static void apply_plan(intersection_t *x, enum PLAN p) {
+    timing_plan_t *run = &tod.running[x->id];
+    *run = config_get()->plans[p];
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        x->timing[t].min_periods = run->min_periods[t];
+        x->timing[t].max_periods = run->max_periods[t];
+    }
+    select_set_mode(x, run->select_mode);
+}
+
+void tod_init(uint32_t now) {
+    tod.seconds = 0;
+    tod.second_start = now;
+    tod.clock_set = FALSE;
+    tod.target = TOD_DEFAULT_PLAN;
+    for (uint8_t i = 0; i < NUM_INTERSECTIONS; i++) {
+        apply_plan(&intersections[i], tod.target);
+    }
+}
+
+// Set the clock, seconds since midnight
+void tod_set(uint32_t s, uint32_t now) {
+    tod.seconds = s % TOD_SECONDS_PER_DAY;
+    tod.second_start = now;
+    tod.clock_set = TRUE;
+}
+
+enum ON tod_is_set(void) {
+    return tod.clock_set;
+}
+
+uint32_t tod_seconds(void) {
+    return tod.seconds;
+}
+
+// Plan the schedule asks for at this time of day
+static enum PLAN scheduled_plan(void) {
+    const tod_entry_t *schedule = config_get()->schedule;
+    uint16_t minute = tod.seconds / 60;
+    uint8_t plan = TOD_DEFAULT_PLAN;
+
+    for (uint8_t i = 0; i < TOD_SCHEDULE_LEN; i++) {
+        if (minute >= schedule[i].start_minute && schedule[i].plan < NUM_PLANS) {
+            plan = schedule[i].plan;
+        }
+    }
+    return plan;
+}
+
+// Advance the clock, called from the main loop
+void tod_update(uint32_t now) {
+    while ((now - tod.second_start) >= 1000) {
+        tod.second_start += 1000;
+        if (++tod.seconds >= TOD_SECONDS_PER_DAY) {
+            tod.seconds = 0;
+        }
+    }
+    tod.target = tod.clock_set ? scheduled_plan() : TOD_DEFAULT_PLAN;
+}
+
+// Move one value at most step towards its target
+static uint16_t step_to(uint16_t value, uint16_t goal, uint16_t step) {
+    if (value + step < goal) return value + step;
+    if (value > goal + step) return value - step;
+    return goal;
+}
+
+// Called when a cycle starts (the rest phase turning green)
+void tod_cycle(intersection_t *x) {
+    timing_plan_t *run = &tod.running[x->id];
+    const timing_plan_t *goal = &config_get()->plans[tod.target];
+
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        run->min_periods[t] = step_to(run->min_periods[t], goal->min_periods[t], TOD_STEP_PERIODS);
+        run->max_periods[t] = step_to(run->max_periods[t], goal->max_periods[t], TOD_STEP_PERIODS);
+        if (run->max_periods[t] <= run->min_periods[t]) {
+            run->max_periods[t] = run->min_periods[t] + 1;
+        }
+
+        // The optimiser sets its own limits while it is on
+        if (!adaptive_enabled(x)) {
+            x->timing[t].min_periods = run->min_periods[t];
+            x->timing[t].max_periods = run->max_periods[t];
+        }
+    }
+    run->period_ms = step_to(run->period_ms, goal->period_ms, TOD_STEP_MS);
+    run->select_mode = goal->select_mode;
+    select_set_mode(x, run->select_mode);
+}
+
+// State preserved across a warm restart
+const void *tod_preserved(uint16_t *len) {
+    *len = sizeof(tod);
+    return &tod;
+}
+
+enum PLAN tod_plan(void) {
+    return tod.target;
+}
+
+// TRUE while the limits in force are still stepping to the plan
+enum ON tod_in_transition(intersection_t *x) {
+    timing_plan_t *run = &tod.running[x->id];
+    const timing_plan_t *goal = &config_get()->plans[tod.target];
+    for (uint8_t t = 0; t < NUM_TIMINGS; t++) {
+        if (run->min_periods[t] != goal->min_periods[t] ||
+            run->max_periods[t] != goal->max_periods[t]) {
+            return TRUE;
+        }
+    }
+    return (run->period_ms != goal->period_ms) ? TRUE : FALSE;
+}
+
+// Base period in force
+uint16_t tod_period_ms(intersection_t *x) {
+    return tod.running[x->id].period_ms;
+}
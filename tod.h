@@ -0,0 +1,67 @@
+/*
+ * File:   tod.h
+ * Author: Traffic Light Controller
+ * 
+ * Time of day clock and timing plans
+ */
+
+#ifndef TOD_H
+#define TOD_H
+
+#include <stdint.h>
+#include "Sensors.h"
+#include "phase_select.h"
+
+#define TOD_SECONDS_PER_DAY     86400UL
+
+// Plan used until the clock has been set
+#define TOD_DEFAULT_PLAN        PLAN_MIDDAY
+
+// Largest change per cycle while moving to a new plan
+#define TOD_STEP_PERIODS        1
+#define TOD_STEP_MS             100
+
+// Timing plans, indexed into the plan table
+enum PLAN {
+    PLAN_NIGHT,
+    PLAN_AM_PEAK,
+    PLAN_MIDDAY,
+    PLAN_PM_PEAK,
+    NUM_PLANS
+};
+
+// One timing plan (program memory)
+typedef struct {
+    uint8_t min_periods[NUM_TIMINGS];
+    uint8_t max_periods[NUM_TIMINGS];
+    uint16_t period_ms;         // Base period, scaled down by the pot
+    uint8_t select_mode;        // enum SELECT_MODE
+} timing_plan_t;
+
+// Schedule entry: plan from start_minute until the next entry
+typedef struct {
+    uint16_t start_minute;
+    uint8_t plan;
+} tod_entry_t;
+
+// Schedule entries, in start order, unused ones start at TOD_UNUSED
+#define TOD_SCHEDULE_LEN        8
+#define TOD_UNUSED              0xFFFF
+
+// Defaults for the configuration (config.c)
+extern const timing_plan_t default_plans[NUM_PLANS] PROGMEM;
+extern const tod_entry_t default_schedule[TOD_SCHEDULE_LEN] PROGMEM;
+
+// Function prototypes
+void tod_init(uint32_t now);
+void tod_set(uint32_t seconds, uint32_t now);
+enum ON tod_is_set(void);
+uint32_t tod_seconds(void);
+void tod_update(uint32_t now);
+void tod_cycle(intersection_t *x);
+enum PLAN tod_plan(void);
+enum ON tod_in_transition(intersection_t *x);
+uint16_t tod_period_ms(intersection_t *x);
+const void *tod_preserved(uint16_t *len);
+
+#endif /* TOD_H */
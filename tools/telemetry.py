@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Decode the controller's telemetry stream (telemetry.c, host.c).
+
+    tools/telemetry.py /dev/ttyUSB0     serial port, set to 38400 8N1
+    tools/telemetry.py /dev/pts/3       pty, e.g. from a simulator
+    tools/telemetry.py capture.bin      a raw capture
+    tools/telemetry.py -                stdin
+
+Each frame is printed on a line of its own. Text outside frames (replies
+to host commands) is printed as it is. Frames with a bad CRC are skipped
+and counted. Commands typed on stdin are not forwarded; use a terminal on
+the same port for those.
+"""
+
+import os
+import struct
+import sys
+import termios
+
+SYNC = 0xA5
+BAUD = termios.B38400
+
+# Default topology (topology.h), indexed by enum STATE and approach number
+STATES = ["Hazard", "Default", "ParkRdWestTurn", "RailwayStThrough", "DamStThrough"]
+APPROACHES = ["dms", "prws", "prwt", "pres", "rws"]
+SENSORS = APPROACHES + ["bus"]
+COLOURS = "_RYG"        # enum COLOUR: OFF, RED, YELLOW, GREEN
+PLANS = ["night", "am-peak", "midday", "pm-peak"]
+TASKS = ["scan", "state", "frame", "lcd"]
+
+
+def crc_ccitt(data, crc=0xFFFF):
+    """_crc_ccitt_update() from avr-libc, over a sequence of bytes."""
+    for b in data:
+        b ^= crc & 0xFF
+        b = (b ^ (b << 4)) & 0xFF
+        crc = ((b << 8) | (crc >> 8)) ^ (b >> 4) ^ (b << 3)
+        crc &= 0xFFFF
+    return crc
+
+
+def name(names, i):
+    return names[i] if i < len(names) else str(i)
+
+
+def decode_state(p):
+    ms, ident, state, hazard = struct.unpack("<IBBB", p)
+    return ms, ident, "state %s%s" % (name(STATES, state), " hazard" if hazard else "")
+
+
+def decode_lights(p):
+    ms, ident, colours = struct.unpack("<IBH", p)
+    lamps = " ".join("%s=%s" % (a, COLOURS[(colours >> (2 * i)) & 3]) for i, a in enumerate(APPROACHES))
+    return ms, ident, "lights " + lamps
+
+
+def decode_sensors(p):
+    ms, ident, pressed = struct.unpack("<IBB", p)
+    on = [s for i, s in enumerate(SENSORS) if pressed & (1 << i)]
+    return ms, ident, "sensors " + (" ".join(on) if on else "-")
+
+
+def decode_period(p):
+    ms, ident, period = struct.unpack("<IBH", p)
+    return ms, ident, "period %d ms" % period
+
+
+def decode_perf(p):
+    fixed = "<IHHHHHBB"
+    head = struct.calcsize(fixed)
+    ms, peak, free, commits, trips, dropped, cause, plan = struct.unpack(fixed, p[:head])
+    late = struct.unpack("<%dI" % ((len(p) - head) // 4), p[head:])
+    worst = " ".join("%s=%dus" % (name(TASKS, i), w) for i, w in enumerate(late))
+    text = ("perf stack %d free %d commits %d trips %d dropped %d reset 0x%02x plan %s late %s"
+            % (peak, free, commits, trips, dropped, cause, name(PLANS, plan), worst))
+    return ms, None, text
+
+
+def decode_bus(p):
+    load = "<BHHHI"
+    size = struct.calcsize(load)
+    ms = struct.unpack("<I", p[:4])[0]
+    buses = []
+    for i, bus in enumerate(("i2c", "spi")):
+        off = 4 + i * size
+        util, trans, nbytes, errors, busy = struct.unpack(load, p[off:off + size])
+        buses.append("%s %d%% %d/s %dB/s err %d busy %dus" % (bus, util, trans, nbytes, errors, busy))
+    return ms, None, "bus " + ", ".join(buses)
+
+
+DECODERS = {
+    1: decode_state,
+    2: decode_lights,
+    3: decode_sensors,
+    4: decode_period,
+    5: decode_perf,
+    6: decode_bus,
+}
+
+
+class Decoder:
+    """Splits the byte stream into frames and text."""
+
+    def __init__(self, out):
+        self.out = out
+        self.buf = bytearray()
+        self.text = bytearray()
+        self.bad = 0
+
+    def flush_text(self):
+        if self.text:
+            self.out.write(self.text.decode("ascii", "replace"))
+            self.out.flush()
+            self.text.clear()
+
+    def frame(self, ftype, payload):
+        self.flush_text()
+        decoder = DECODERS.get(ftype)
+        if decoder is None:
+            self.out.write("type %d: %s\n" % (ftype, payload.hex()))
+            return
+        try:
+            ms, ident, text = decoder(bytes(payload))
+        except struct.error:
+            self.out.write("type %d bad length %d\n" % (ftype, len(payload)))
+            return
+        where = "" if ident is None else " x%d" % ident
+        self.out.write("%10.3f%s %s\n" % (ms / 1000.0, where, text))
+        self.out.flush()
+
+    def feed(self, data):
+        self.buf += data
+        while self.buf:
+            if self.buf[0] != SYNC:
+                self.text.append(self.buf.pop(0))
+                continue
+            if len(self.buf) < 3:
+                break
+            length = self.buf[2]
+            end = 3 + length + 2
+            if len(self.buf) < end:
+                break
+            body = self.buf[1:3 + length]
+            crc = self.buf[end - 2] | (self.buf[end - 1] << 8)
+            if crc_ccitt(body) != crc:
+                # Not a frame after all, keep the byte as text and resync
+                self.bad += 1
+                self.text.append(self.buf.pop(0))
+                continue
+            self.frame(self.buf[1], self.buf[3:3 + length])
+            del self.buf[:end]
+        if not self.buf:
+            self.flush_text()
+
+
+def open_stream(path):
+    if path == "-":
+        return sys.stdin.buffer.fileno()
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        attrs = termios.tcgetattr(fd)
+        attrs[0] = 0                                        # iflag: raw
+        attrs[1] = 0                                        # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0                                        # lflag: no echo, no lines
+        attrs[4] = attrs[5] = BAUD
+        attrs[6][termios.VMIN] = 1
+        attrs[6][termios.VTIME] = 0
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        return 2
+    fd = open_stream(sys.argv[1])
+    dec = Decoder(sys.stdout)
+    try:
+        while True:
+            data = os.read(fd, 256)
+            if not data:
+                break
+            dec.feed(data)
+    except KeyboardInterrupt:
+        pass
+    dec.flush_text()
+    if dec.bad:
+        sys.stderr.write("%d bad frames\n" % dec.bad)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,93 @@
+/*
+ * File:   topology.h
+ * Author: Traffic Light Controller
+ *
+ * Intersection topology: approaches, detectors, timing blocks and phases.
+ *
+ * This is the one place the geometry of the site is described. Each list
+ * is an X-macro: Sensors.h expands them into the approach, sensor, timing
+ * and phase enums, and Sensors.c, monitor.c, io_map.c and LCD.c expand
+ * them into their program memory tables. Nothing else names an approach
+ * or a lamp bit, so a different site only needs its own copy of this file.
+ *
+ * Output bits are numbered in the 24 bit output word: bits 0-15 are the
+ * port expander's GPIOA/GPIOB, bits 16-23 the intersection's lamp_port.
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+// Marks an unused approach slot
+#define NO_APPROACH 0xFF
+
+// Approaches, in approach number order
+// X(name, LCD label, LCD direction, green bit, yellow bit, red bit, conflicts)
+// conflicts are the approaches it may never show green or yellow alongside
+#define TOPOLOGY_APPROACHES(X) \
+    X(dms,  "DST", ' ', 1,  2,  3,  APPROACH_BIT(prws) | APPROACH_BIT(prwt) | APPROACH_BIT(pres) | APPROACH_BIT(rws)) \
+    X(prws, "PRT", 'W', 5,  6,  7,  APPROACH_BIT(dms) | APPROACH_BIT(rws)) \
+    X(prwt, "PWT", 'W', 9,  10, 11, APPROACH_BIT(dms) | APPROACH_BIT(pres) | APPROACH_BIT(rws)) \
+    X(pres, "PRE", 'E', 13, 14, 15, APPROACH_BIT(dms) | APPROACH_BIT(prwt) | APPROACH_BIT(rws)) \
+    X(rws,  "RST", ' ', 17, 18, 19, APPROACH_BIT(dms) | APPROACH_BIT(prws) | APPROACH_BIT(prwt) | APPROACH_BIT(pres))
+
+// The conflict monitor's own list, written out in full both ways rather
+// than taken from the column above, so one slip can't reach the phase
+// logic and the monitor together. monitor_init() cross-checks the two.
+// X(approach, approaches it may never show green or yellow alongside)
+#define TOPOLOGY_MONITOR_CONFLICTS(X) \
+    X(dms,  APPROACH_BIT(prws) | APPROACH_BIT(prwt) | APPROACH_BIT(pres) | APPROACH_BIT(rws)) \
+    X(prws, APPROACH_BIT(dms) | APPROACH_BIT(rws)) \
+    X(prwt, APPROACH_BIT(dms) | APPROACH_BIT(pres) | APPROACH_BIT(rws)) \
+    X(pres, APPROACH_BIT(dms) | APPROACH_BIT(prwt) | APPROACH_BIT(rws)) \
+    X(rws,  APPROACH_BIT(dms) | APPROACH_BIT(prws) | APPROACH_BIT(prwt) | APPROACH_BIT(pres))
+
+// Detectors, in sensor number order: one per approach, in the same
+// order, then any others. Wiring of the first intersection.
+// X(name, enum IO_SOURCE, bit)
+#define TOPOLOGY_SENSORS(X) \
+    X(dms,  IO_GPIOA, 0) \
+    X(prws, IO_GPIOA, 4) \
+    X(prwt, IO_GPIOB, 0) \
+    X(pres, IO_GPIOB, 4) \
+    X(rws,  IO_PINB,  0) \
+    X(bus,  IO_PIND,  6)
+
+// Timing blocks
+// X(name, min periods, max periods, passage periods,
+//   optimiser min low, min high, max low, max high)
+#define TOPOLOGY_TIMINGS(X) \
+    X(TIMING_PRWS, 4, 6, 2, 4, 6, 5, 20) \
+    X(TIMING_PRWT, 2, 4, 1, 2, 3, 3, 10) \
+    X(TIMING_RWS,  2, 3, 1, 2, 3, 3, 10) \
+    X(TIMING_DMS,  2, 4, 1, 2, 3, 3, 10)
+
+// Phases, after Hazard. Bits are approach (and sensor) bits.
+// X(name, lead, overlap, serves, calls, yields_to, priority, timing, flags,
+//   LCD approaches)
+#define TOPOLOGY_PHASES(X) \
+    /* Park Road through both ways, rests here with no demand */ \
+    X(Default, \
+      APPROACH_BIT(prws) | APPROACH_BIT(pres), 0, \
+      APPROACH_BIT(prws) | APPROACH_BIT(pres), APPROACH_BIT(prws) | APPROACH_BIT(pres), \
+      APPROACH_BIT(rws) | APPROACH_BIT(dms), 0, TIMING_PRWS, PHASE_REST, \
+      prws, NO_APPROACH) \
+    /* Turn with Park Road West straight carried alongside */ \
+    X(ParkRdWestTurn, \
+      APPROACH_BIT(prwt), APPROACH_BIT(prws), \
+      APPROACH_BIT(prwt), APPROACH_BIT(prwt), \
+      APPROACH_BIT(rws) | APPROACH_BIT(dms), 1, TIMING_PRWT, 0, \
+      prws, prwt) \
+    /* Yields to Dam Street */ \
+    X(RailwayStThrough, \
+      APPROACH_BIT(rws), 0, \
+      APPROACH_BIT(rws), APPROACH_BIT(rws), \
+      APPROACH_BIT(dms), 2, TIMING_RWS, 0, \
+      rws, NO_APPROACH) \
+    /* Highest priority, never yields to a sensor */ \
+    X(DamStThrough, \
+      APPROACH_BIT(dms), 0, \
+      APPROACH_BIT(dms), APPROACH_BIT(dms), \
+      0, 3, TIMING_DMS, 0, \
+      dms, NO_APPROACH)
+
+#endif /* TOPOLOGY_H */
@@ -0,0 +1,114 @@
+/*
+ * File:   trace.h
+ * Author: Traffic Light Controller
+ * 
+ * Logic analyser trace probes on PD4, PD5 and PD7.
+ *
+ * Named code regions drive the spare port D pins so their timing can be
+ * captured with a logic analyser. The mode is chosen at build time:
+ *
+ *   TRACE_OFF      (default) the probes compile to nothing
+ *   TRACE_PINS     each probe with a pin sets it on entry and clears it
+ *                  on exit with a single sbi/cbi
+ *   TRACE_ENCODED  every probe puts a 3 bit code on PD4/PD5/PD7, the
+ *                  region's own code while it runs, and a state transition
+ *                  shows its code for one write
+ *
+ * e.g. -DTRACE=TRACE_ENCODED. In encoded mode a region saves the code it
+ * found on entry and puts it back on exit, so the pins always show the
+ * innermost region running: an interrupt in the middle of an SPI command
+ * shows its own code, then the SPI code again. Each change is one out to
+ * PIND toggling only the code pins. There are fewer pins than probes, so
+ * in pin mode the hazard, host and clock interrupts aren't shown.
+ * PD6 is the bus detector and is never used.
+ *
+ * A region begun and ended in one block uses TRACE_BEGIN/TRACE_END, which
+ * keep the saved code in a local. One that spans calls, like an I2C
+ * transaction, declares TRACE_SLOT at file scope and uses
+ * TRACE_OPEN/TRACE_CLOSE. Neither form may nest inside itself.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define TRACE_OFF       0
+#define TRACE_PINS      1
+#define TRACE_ENCODED   2
+
+#ifndef TRACE
+#define TRACE TRACE_OFF
+#endif
+
+// Probe pins, outputs from setup_hardware()
+#define TRACE_PD4       _BV(4)
+#define TRACE_PD5       _BV(5)
+#define TRACE_PD7       _BV(7)
+#define TRACE_CODE_MASK (TRACE_PD4 | TRACE_PD5 | TRACE_PD7)
+
+// Code bits 0 and 1 on PD4/PD5, bit 2 on PD7
+#define TRACE_CODE_PINS(code) ((((code) & 3) << 4) | (((code) & 4) << 5))
+
+// Probes
+// X(name, TRACE_PINS pin or 0 for none, TRACE_ENCODED code 1-7)
+#define TRACE_PROBES(X) \
+    X(FRAME_ISR,  TRACE_PD4, 1)  /* Frame interrupt */ \
+    X(SPI,        TRACE_PD5, 2)  /* MCP23S17 command */ \
+    X(I2C,        0,         3)  /* I2C start to stop */ \
+    X(HAZARD_ISR, 0,         4)  /* INT1, hazard switch edge */ \
+    X(HOST_ISR,   0,         5)  /* USART receive or transmit */ \
+    X(CLOCK_ISR,  0,         6)  /* Timer2 millisecond tick */ \
+    X(STATE,      TRACE_PD7, 7)  /* Phase change, pulse only */
+
+#define TRACE_PIN_ID(name, pin, code) TRACE_PIN_##name = (pin),
+#define TRACE_CODE_ID(name, pin, code) TRACE_CODE_##name = TRACE_CODE_PINS(code),
+enum { TRACE_PROBES(TRACE_PIN_ID) };
+enum { TRACE_PROBES(TRACE_CODE_ID) };
+#undef TRACE_PIN_ID
+#undef TRACE_CODE_ID
+
+#if TRACE == TRACE_PINS
+
+#define TRACE_BEGIN(p)  do { if (TRACE_PIN_##p) PORTD |= TRACE_PIN_##p; } while (0)
+#define TRACE_END(p)    do { if (TRACE_PIN_##p) PORTD &= ~TRACE_PIN_##p; } while (0)
+#define TRACE_PULSE(p)  do { TRACE_BEGIN(p); TRACE_END(p); } while (0)
+#define TRACE_SLOT(p)   extern uint8_t trace_slot_##p
+#define TRACE_OPEN(p)   TRACE_BEGIN(p)
+#define TRACE_CLOSE(p)  TRACE_END(p)
+
+#elif TRACE == TRACE_ENCODED
+
+// Show code, returns the code it replaced. An interrupt between the read
+// and the write puts back what it found, so the read still holds.
+static inline uint8_t trace_enter(uint8_t code) {
+    uint8_t saved = PORTD & TRACE_CODE_MASK;
+    PIND = saved ^ code;
+    return saved;
+}
+
+// Put back the code saved on entry
+static inline void trace_leave(uint8_t saved) {
+    PIND = (PORTD & TRACE_CODE_MASK) ^ saved;
+}
+
+#define TRACE_BEGIN(p)  uint8_t trace_saved_##p = trace_enter(TRACE_CODE_##p)
+#define TRACE_END(p)    trace_leave(trace_saved_##p)
+#define TRACE_PULSE(p)  trace_leave(trace_enter(TRACE_CODE_##p))
+#define TRACE_SLOT(p)   static uint8_t trace_slot_##p
+#define TRACE_OPEN(p)   trace_slot_##p = trace_enter(TRACE_CODE_##p)
+#define TRACE_CLOSE(p)  trace_leave(trace_slot_##p)
+
+#else
+
+#define TRACE_BEGIN(p)
+#define TRACE_END(p)
+#define TRACE_PULSE(p)
+#define TRACE_SLOT(p)   extern uint8_t trace_slot_##p
+#define TRACE_OPEN(p)
+#define TRACE_CLOSE(p)
+
+#endif
+
+#endif /* TRACE_H */
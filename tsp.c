@@ -0,0 +1,199 @@
+/*
+ * File:   tsp.c
+ * Author: Traffic Light Controller
+ * 
+ * Transit signal priority.
+ *
+ * A bus seen on S5 while its phase is green holds that green (up to the
+ * phase's max_periods) until the bus has cleared the stop line. A bus seen
+ * while its phase is not running places a priority call: the running phase
+ * yields as soon as its min_periods are up and the bus phase is served next.
+ *
+ * Delay saved is estimated per bus: an extension that was actually needed
+ * saves the red the bus would otherwise have sat through (the last measured
+ * red of the bus phase), an early green saves the green time cut from the
+ * conflicting phase. The log goes to the host with the B command.
+ */
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "Sensors.h"
+#include "intersection.h"
+#include "host.h"
+#include "tsp.h"
+
+// Transit priority state of one intersection
+typedef struct {
+    tsp_log_t log;
+    enum ON bus_present;    // Bus over the detector
+    enum ON bus_waiting;    // Priority call placed on red
+    enum ON bus_on_green;   // Bus being carried through a green
+    enum ON bus_extended;   // Green held past its natural end
+    uint32_t bus_release;   // When the bus left the detector
+    uint32_t cut_ms;        // Green cut from other phases for this call
+    uint32_t last_red_ms;   // Last red period of the bus phase
+} tsp_t;
+
+// Kept across a warm restart (restart.c)
+static tsp_t tsp[NUM_INTERSECTIONS] __attribute__((section(".noinit")));
+
+static const char dump_header[] PROGMEM = "id calls extensions early_greens saved_s\r\n";
+static const char dump_eol[] PROGMEM = "\r\n";
+
+static void add_saved(tsp_t *t, uint32_t ms) {
+    t->log.saved_ms += ms;
+}
+
+// Cold start: no bus about, nothing saved yet
+void tsp_init(intersection_t *x) {
+    tsp_t *t = &tsp[x->id];
+
+    t->log.calls = 0;
+    t->log.extensions = 0;
+    t->log.early_greens = 0;
+    t->log.saved_ms = 0;
+    t->bus_present = FALSE;
+    t->bus_release = 0;
+    t->last_red_ms = 0;
+    tsp_reset(x);
+}
+
+// State preserved across a warm restart
+const void *tsp_preserved(uint16_t *len) {
+    *len = sizeof(tsp);
+    return tsp;
+}
+
+void tsp_reset(intersection_t *x) {
+    tsp_t *t = &tsp[x->id];
+
+    t->bus_waiting = FALSE;
+    t->bus_on_green = FALSE;
+    t->bus_extended = FALSE;
+    t->cut_ms = 0;
+}
+
+// Debounced S5 edge from update_sensor_states()
+void tsp_sensor_edge(intersection_t *x, uint8_t pressed, uint32_t now) {
+    tsp_t *t = &tsp[x->id];
+
+    if (!pressed) {
+        t->bus_present = FALSE;
+        t->bus_release = now;
+        return;
+    }
+
+    t->bus_present = TRUE;
+    if (t->log.calls < 0xFFFF) {
+        t->log.calls++;
+    }
+    if (x->hazard) {
+        return;
+    }
+    if (x->state == TSP_PHASE && GET_COLOUR(x, TSP_APPROACH) == GREEN) {
+        t->bus_on_green = TRUE;
+    } else {
+        t->bus_waiting = TRUE;
+    }
+}
+
+// TRUE while a bus is waiting for its phase
+enum ON tsp_waiting(intersection_t *x) {
+    return tsp[x->id].bus_waiting;
+}
+
+// TRUE while the bus phase green should be held for a bus
+enum ON tsp_hold(intersection_t *x, uint32_t now) {
+    tsp_t *t = &tsp[x->id];
+
+    if (!t->bus_on_green) {
+        return FALSE;
+    }
+    if (t->bus_present || (now - t->bus_release) < TSP_CLEAR_MS) {
+        return TRUE;
+    }
+
+    // Bus is through on this green
+    if (t->bus_extended) {
+        add_saved(t, t->last_red_ms);
+    }
+    t->bus_on_green = FALSE;
+    t->bus_extended = FALSE;
+    return FALSE;
+}
+
+// The bus phase would have ended here without the hold
+void tsp_extended(intersection_t *x) {
+    tsp_t *t = &tsp[x->id];
+
+    if (!t->bus_extended) {
+        t->bus_extended = TRUE;
+        if (t->log.extensions < 0xFFFF) {
+            t->log.extensions++;
+        }
+    }
+}
+
+// A conflicting green was ended early for the bus
+void tsp_cut(intersection_t *x, uint32_t ms) {
+    tsp[x->id].cut_ms += ms;
+}
+
+// The bus phase has turned green after red_ms of red
+void tsp_phase_green(intersection_t *x, uint32_t red_ms) {
+    tsp_t *t = &tsp[x->id];
+
+    t->last_red_ms = red_ms;
+    if (t->bus_waiting) {
+        t->bus_waiting = FALSE;
+        t->bus_on_green = TRUE;
+        if (t->cut_ms) {
+            if (t->log.early_greens < 0xFFFF) {
+                t->log.early_greens++;
+            }
+            add_saved(t, t->cut_ms);
+            t->cut_ms = 0;
+        }
+    }
+}
+
+// The bus phase has finished, a held bus that didn't clear gets no credit
+void tsp_phase_ended(intersection_t *x) {
+    tsp_t *t = &tsp[x->id];
+
+    t->bus_on_green = FALSE;
+    t->bus_extended = FALSE;
+}
+
+const tsp_log_t* tsp_get_log(intersection_t *x) {
+    return &tsp[x->id].log;
+}
+
+uint16_t tsp_saved_seconds(intersection_t *x) {
+    uint32_t s = tsp[x->id].log.saved_ms / 1000;
+    return (s > 0xFFFF) ? 0xFFFF : s;
+}
+
+// Write the logs to the host, one step per intersection
+enum ON tsp_dump(uint16_t step) {
+    if (step == 0) {
+        host_puts_P(dump_header);
+        return TRUE;
+    }
+    uint8_t i = step - 1;
+    intersection_t *x = &intersections[i];
+    const tsp_log_t *log = tsp_get_log(x);
+
+    host_putc('x');
+    host_put_number(i);
+    host_putc(' ');
+    host_put_number(log->calls);
+    host_putc(' ');
+    host_put_number(log->extensions);
+    host_putc(' ');
+    host_put_number(log->early_greens);
+    host_putc(' ');
+    host_put_number(tsp_saved_seconds(x));
+    host_puts_P(dump_eol);
+    return (i + 1 < NUM_INTERSECTIONS) ? TRUE : FALSE;
+}
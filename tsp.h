@@ -0,0 +1,47 @@
+/*
+ * File:   tsp.h
+ * Author: Traffic Light Controller
+ * 
+ * Transit signal priority from the S5 bus sensor (PD6)
+ */
+
+#ifndef TSP_H
+#define TSP_H
+
+#include <stdint.h>
+#include "Sensors.h"
+
+// Phase and approach the bus lane runs on
+#define TSP_PHASE       Default
+#define TSP_APPROACH    prws
+
+// Bus sensor number in sensor_manager
+#define TSP_SENSOR      SENSOR_bus
+
+// Time for the bus to clear the stop line after leaving the detector
+#define TSP_CLEAR_MS    2000
+
+// Transit priority log
+typedef struct {
+    uint16_t calls;         // Buses detected
+    uint16_t extensions;    // Greens held past their natural end for a bus
+    uint16_t early_greens;  // Conflicting greens cut short for a bus
+    uint32_t saved_ms;      // Estimated bus delay saved
+} tsp_log_t;
+
+// Function prototypes
+void tsp_init(intersection_t *x);
+const void *tsp_preserved(uint16_t *len);
+void tsp_reset(intersection_t *x);
+void tsp_sensor_edge(intersection_t *x, uint8_t pressed, uint32_t now);
+enum ON tsp_waiting(intersection_t *x);
+enum ON tsp_hold(intersection_t *x, uint32_t now);
+void tsp_extended(intersection_t *x);
+void tsp_cut(intersection_t *x, uint32_t cut_ms);
+void tsp_phase_green(intersection_t *x, uint32_t red_ms);
+void tsp_phase_ended(intersection_t *x);
+const tsp_log_t* tsp_get_log(intersection_t *x);
+uint16_t tsp_saved_seconds(intersection_t *x);
+enum ON tsp_dump(uint16_t step);
+
+#endif /* TSP_H */